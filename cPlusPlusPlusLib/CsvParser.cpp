@@ -0,0 +1,418 @@
+/*
+* This is the cpp file for the CsvParser class of cPlusPlusPlusLib
+* cPPPLib - A library of functions that should be in the C++ Standard Library
+* (C) - Charles Machalow - MIT License
+*/
+
+#ifndef CsvParser_CPP
+#define CsvParser_CPP
+
+#include "CsvParser.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CSV_USE_SSE2
+#include <emmintrin.h>
+#endif //SSE2
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif //_MSC_VER && _M_X64
+
+// The input is scanned this many bytes at a time, one bit per byte
+static const size_t CSV_BLOCK_SIZE = 64;
+
+/// <summary>
+/// Constructor for a CsvParser over a range of chars
+/// </summary>
+/// <param name="data">Pointer to the first char. Must outlive the parser</param>
+/// <param name="size">Number of chars</param>
+/// <param name="delim">Char separating fields (Defaults to ',')</param>
+/// <param name="quote">Char used to quote fields (Defaults to '"')</param>
+CsvParser::CsvParser(const char *data, const size_t &size, const char &delim, const char &quote)
+	: data(data), size(size), delim(delim), quote(quote), next_block(0), block_start(0), structural_bits(0), inside_quote(0), field_start(0), bad_quote(StringView::npos), error(false), error_offset(0)
+{
+}
+
+/// <summary>
+/// Constructor for a CsvParser over a std::string
+/// </summary>
+/// <param name="str">The std::string to parse. Must outlive the parser</param>
+/// <param name="delim">Char separating fields (Defaults to ',')</param>
+/// <param name="quote">Char used to quote fields (Defaults to '"')</param>
+CsvParser::CsvParser(const std::string &str, const char &delim, const char &quote)
+	: CsvParser(str.data(), str.size(), delim, quote)
+{
+}
+
+/// <summary>
+/// Parses the next record.
+/// Structural chars are found a block at a time, so the per-field cost is a bit scan rather than a per-char loop.
+/// A blank line is a record holding a single empty field.
+/// </summary>
+/// <param name="fields">std::vector<StringView>, passed by reference. Cleared, then filled with the fields of the record.
+/// Reusing the same std::vector across calls avoids reallocating it.</param>
+/// <returns>True if a record was parsed. False at the end of the input or if the input is malformed (see failed())</returns>
+bool CsvParser::nextRecord(std::vector<StringView> &fields)
+{
+	fields.clear();
+
+	if (error || field_start > size)
+	{
+		return false;
+	}
+
+	while (true)
+	{
+		while (structural_bits == 0)
+		{
+			// Every structural char before the out of place quote has been handed out, so field_start is the bad field
+			if (bad_quote != StringView::npos)
+			{
+				fail(field_start);
+				return false;
+			}
+
+			if (next_block >= size)
+			{
+				if (inside_quote != 0)
+				{
+					fail(field_start);
+					return false;
+				}
+
+				// The last record may not end with a line break
+				bool has_record = field_start < size || !fields.empty();
+				bool added = has_record && addField(size, true, fields);
+				field_start = size + 1;
+				return added;
+			}
+
+			scanNextBlock();
+		}
+
+		size_t pos = block_start + CsvParser::lowestBit(structural_bits);
+		structural_bits &= structural_bits - 1;
+
+		bool ends_record = data[pos] != delim;
+		if (!addField(pos, ends_record, fields))
+		{
+			return false;
+		}
+		field_start = pos + 1;
+
+		if (ends_record)
+		{
+			return true;
+		}
+	}
+}
+
+/// <summary>
+/// Determines if the parser stopped on malformed input
+/// </summary>
+/// <returns>True if a quote was never closed, or a quote char was out of place (inside an unquoted field, or followed by text after closing a quoted one)</returns>
+bool CsvParser::failed() const
+{
+	return error;
+}
+
+/// <summary>
+/// Gets where the malformed input was found
+/// </summary>
+/// <returns>Offset of the start of the bad field, only meaningful if failed() is true</returns>
+size_t CsvParser::errorOffset() const
+{
+	return error_offset;
+}
+
+/// <summary>
+/// Determines if a field needs unescape() to get its text
+/// </summary>
+/// <param name="field">A field given by nextRecord()</param>
+/// <returns>True if the field holds a quote char</returns>
+bool CsvParser::needsUnescape(const StringView &field) const
+{
+	return field.find(quote) != StringView::npos;
+}
+
+/// <summary>
+/// Gets the text of a field, turning each doubled quote char into a single one
+/// </summary>
+/// <param name="field">A field given by nextRecord()</param>
+/// <returns>std::string of the field's text</returns>
+std::string CsvParser::unescape(const StringView &field) const
+{
+	std::string ret_str;
+	unescape(field, ret_str);
+	return ret_str;
+}
+
+/// <summary>
+/// Gets the text of a field into an existing std::string, turning each doubled quote char into a single one.
+/// Reusing the same std::string across calls avoids reallocating it.
+/// </summary>
+/// <param name="field">A field given by nextRecord()</param>
+/// <param name="out">std::string, passed by reference. Replaced with the field's text</param>
+void CsvParser::unescape(const StringView &field, std::string &out) const
+{
+	out.clear();
+	out.reserve(field.size());
+
+	size_t pos = 0;
+	while (pos < field.size())
+	{
+		size_t found = field.find(quote, pos);
+		if (found == StringView::npos)
+		{
+			out.append(field.data() + pos, field.size() - pos);
+			break;
+		}
+
+		out.append(field.data() + pos, found - pos + 1);
+		pos = found + 1;
+
+		// Skip the second quote char of a doubled pair
+		if (pos < field.size() && field[pos] == quote)
+		{
+			pos++;
+		}
+	}
+}
+
+/// <summary>
+/// Parses all records of a std::string, copying out each field's text
+/// </summary>
+/// <param name="str">The std::string to parse</param>
+/// <param name="delim">Char separating fields (Defaults to ',')</param>
+/// <param name="quote">Char used to quote fields (Defaults to '"')</param>
+/// <returns>std::vector of records, each a std::vector<std::string> of fields. Stops at the first malformed record</returns>
+std::vector<std::vector<std::string>> CsvParser::parse(const std::string &str, const char &delim, const char &quote)
+{
+	std::vector<std::vector<std::string>> ret_vec;
+	std::vector<StringView> fields;
+	CsvParser parser(str, delim, quote);
+
+	while (parser.nextRecord(fields))
+	{
+		std::vector<std::string> record(fields.size());
+		for (size_t i = 0; i < fields.size(); i++)
+		{
+			parser.unescape(fields[i], record[i]);
+		}
+		ret_vec.push_back(std::move(record));
+	}
+
+	if (parser.failed())
+	{
+		std::cerr << "ERROR: Malformed field at offset " << parser.errorOffset() << std::endl;
+	}
+
+	return ret_vec;
+}
+
+/// <summary>
+/// Finds the structural chars (unquoted delimiters and line feeds) of the next block of input.
+/// Quote regions are found with a prefix XOR of the quote bits: every bit after an odd number of quotes is inside.
+/// A doubled quote toggles twice, so it never ends a region. inside_quote carries the state into the next block.
+/// </summary>
+void CsvParser::scanNextBlock()
+{
+	const char *block = data + next_block;
+	size_t length = std::min(CSV_BLOCK_SIZE, size - next_block);
+	char padded[CSV_BLOCK_SIZE];
+
+	if (length < CSV_BLOCK_SIZE)
+	{
+		memset(padded, 0, sizeof(padded));
+		memcpy(padded, block, length);
+		block = padded;
+	}
+
+	uint64_t quote_bits = 0;
+	uint64_t candidate_bits = 0;
+	CsvParser::matchBlock(block, delim, quote, quote_bits, candidate_bits);
+
+	if (length < CSV_BLOCK_SIZE)
+	{
+		uint64_t valid = (static_cast<uint64_t>(1) << length) - 1;
+		quote_bits &= valid;
+		candidate_bits &= valid;
+	}
+
+	uint64_t quoted = CsvParser::prefixXor(quote_bits) ^ inside_quote;
+	inside_quote = static_cast<uint64_t>(static_cast<int64_t>(quoted) >> 63);
+
+	structural_bits = candidate_bits & ~quoted;
+	block_start = next_block;
+	next_block += CSV_BLOCK_SIZE;
+
+	// The quote state is only right up to an out of place quote, so nothing from it on is handed out
+	size_t bad = findBadQuote(quote_bits, quoted);
+	if (bad != StringView::npos)
+	{
+		structural_bits &= (static_cast<uint64_t>(1) << bad) - 1;
+		bad_quote = block_start + bad;
+		next_block = size;
+	}
+}
+
+/// <summary>
+/// Finds the first quote char of the current block that is out of place.
+/// An opening quote must start a field: it follows the start of the input, a delimiter, a line feed, or (as the second char of a doubled quote) a closing quote.
+/// A closing quote must end a field: it is followed by the end of the input, a delimiter, a line break, or (as the first char of a doubled quote) an opening quote.
+/// </summary>
+/// <param name="quote_bits">Bit i set if the char i of the block is a quote char</param>
+/// <param name="quoted">Bit i set if char i of the block is inside quotes. An opening quote is inside, a closing quote is not</param>
+/// <returns>Index in the block of the first out of place quote char, or StringView::npos if there is none</returns>
+size_t CsvParser::findBadQuote(uint64_t quote_bits, const uint64_t &quoted) const
+{
+	while (quote_bits != 0)
+	{
+		size_t bit = CsvParser::lowestBit(quote_bits);
+		quote_bits &= quote_bits - 1;
+		size_t pos = block_start + bit;
+
+		if ((quoted >> bit) & 1)
+		{
+			if (pos != 0 && data[pos - 1] != delim && data[pos - 1] != '\n' && data[pos - 1] != quote)
+			{
+				return bit;
+			}
+		}
+		else if (pos + 1 < size)
+		{
+			char next = data[pos + 1];
+			if (next != delim && next != '\n' && next != '\r' && next != quote)
+			{
+				return bit;
+			}
+		}
+	}
+
+	return StringView::npos;
+}
+
+/// <summary>
+/// Adds the field running from field_start to end, stripping its quotes and a CR before a line feed
+/// </summary>
+/// <param name="end">Offset of the char after the field</param>
+/// <param name="ends_record">True if the field is the last of its record</param>
+/// <param name="fields">std::vector<StringView>, passed by reference. Gets the field</param>
+/// <returns>True on success, False if the field is malformed</returns>
+bool CsvParser::addField(const size_t &end, const bool &ends_record, std::vector<StringView> &fields)
+{
+	size_t start = field_start;
+	size_t stop = end;
+
+	if (ends_record && stop > start && data[stop - 1] == '\r')
+	{
+		stop--;
+	}
+
+	if (stop > start && data[start] == quote)
+	{
+		if (stop - start < 2 || data[stop - 1] != quote)
+		{
+			fail(start);
+			return false;
+		}
+		start++;
+		stop--;
+	}
+
+	fields.push_back(StringView(data + start, stop - start));
+	return true;
+}
+
+/// <summary>
+/// Records that malformed input was found
+/// </summary>
+/// <param name="offset">Offset of the start of the bad field</param>
+void CsvParser::fail(const size_t &offset)
+{
+	error = true;
+	error_offset = offset;
+	structural_bits = 0;
+}
+
+/// <summary>
+/// Builds bitmasks of where the quote char and the structural candidates (delimiter or line feed) are in a block
+/// </summary>
+/// <param name="block">Pointer to CSV_BLOCK_SIZE chars</param>
+/// <param name="delim">Char separating fields</param>
+/// <param name="quote">Char used to quote fields</param>
+/// <param name="quote_bits">uint64_t, passed by reference. Gets bit i set if block[i] is quote</param>
+/// <param name="structural_bits">uint64_t, passed by reference. Gets bit i set if block[i] is delim or a line feed</param>
+void CsvParser::matchBlock(const char *block, const char &delim, const char &quote, uint64_t &quote_bits, uint64_t &structural_bits)
+{
+#ifdef CSV_USE_SSE2
+	const __m128i quote_vec = _mm_set1_epi8(quote);
+	const __m128i delim_vec = _mm_set1_epi8(delim);
+	const __m128i newline_vec = _mm_set1_epi8('\n');
+
+	quote_bits = 0;
+	structural_bits = 0;
+	for (size_t i = 0; i < CSV_BLOCK_SIZE; i += 16)
+	{
+		__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i));
+		uint64_t quotes = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote_vec)));
+		uint64_t candidates = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, delim_vec), _mm_cmpeq_epi8(chunk, newline_vec))));
+
+		quote_bits |= quotes << i;
+		structural_bits |= candidates << i;
+	}
+#else
+	quote_bits = 0;
+	structural_bits = 0;
+	for (size_t i = 0; i < CSV_BLOCK_SIZE; i++)
+	{
+		quote_bits |= static_cast<uint64_t>(block[i] == quote) << i;
+		structural_bits |= static_cast<uint64_t>(block[i] == delim || block[i] == '\n') << i;
+	}
+#endif //CSV_USE_SSE2
+}
+
+/// <summary>
+/// Computes the running XOR of a bitmask from the lowest bit up
+/// </summary>
+/// <param name="bits">The bitmask</param>
+/// <returns>Bitmask where bit i is the XOR of bits 0 through i</returns>
+uint64_t CsvParser::prefixXor(uint64_t bits)
+{
+	bits ^= bits << 1;
+	bits ^= bits << 2;
+	bits ^= bits << 4;
+	bits ^= bits << 8;
+	bits ^= bits << 16;
+	bits ^= bits << 32;
+	return bits;
+}
+
+/// <summary>
+/// Gets the index of the lowest set bit
+/// </summary>
+/// <param name="bits">Non-zero bitmask</param>
+/// <returns>Index of the lowest set bit</returns>
+size_t CsvParser::lowestBit(const uint64_t &bits)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return static_cast<size_t>(__builtin_ctzll(bits));
+#elif defined(_MSC_VER) && defined(_M_X64)
+	unsigned long index = 0;
+	_BitScanForward64(&index, bits);
+	return static_cast<size_t>(index);
+#else
+	size_t index = 0;
+	while (((bits >> index) & 1) == 0)
+	{
+		index++;
+	}
+	return index;
+#endif //__GNUC__ || __clang__
+}
+
+#endif CsvParser_CPP
@@ -0,0 +1,66 @@
+/*
+* This is the header file for the CsvParser class of cPlusPlusPlusLib
+* cPPPLib - A library of functions that should be in the C++ Standard Library
+* (C) - Charles Machalow - MIT License
+*/
+
+#ifndef CsvParser_H
+#define CsvParser_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "StringView.h"
+
+/// <summary>
+/// Zero-copy parser for delimited records (RFC 4180 CSV by default).
+/// Fields are handed out as StringViews into the original buffer, with the surrounding quotes removed.
+/// A quoted field may still hold doubled quote chars; use unescape() to get its text when needsUnescape() is true.
+/// Records end at LF or CRLF outside of quotes. Delimiters and line breaks inside quotes are part of the field.
+/// The buffer must outlive the parser and any StringViews it hands out.
+/// </summary>
+class CsvParser
+{
+public:
+	CsvParser(const char *data, const size_t &size, const char &delim = ',', const char &quote = '"');
+	CsvParser(const std::string &str, const char &delim = ',', const char &quote = '"');
+	CsvParser(std::string &&str, const char &delim = ',', const char &quote = '"') = delete;
+
+	bool nextRecord(std::vector<StringView> &fields);
+	bool failed() const;
+	size_t errorOffset() const;
+
+	bool needsUnescape(const StringView &field) const;
+	std::string unescape(const StringView &field) const;
+	void unescape(const StringView &field, std::string &out) const;
+
+	static std::vector<std::vector<std::string>> parse(const std::string &str, const char &delim = ',', const char &quote = '"');
+
+private:
+	void scanNextBlock();
+	size_t findBadQuote(uint64_t quote_bits, const uint64_t &quoted) const;
+	bool addField(const size_t &end, const bool &ends_record, std::vector<StringView> &fields);
+	void fail(const size_t &offset);
+
+	static void matchBlock(const char *block, const char &delim, const char &quote, uint64_t &quote_bits, uint64_t &structural_bits);
+	static uint64_t prefixXor(uint64_t bits);
+	static size_t lowestBit(const uint64_t &bits);
+
+	const char *data;
+	size_t size;
+	char delim;
+	char quote;
+
+	size_t next_block;
+	size_t block_start;
+	uint64_t structural_bits;
+	uint64_t inside_quote;
+
+	size_t field_start;
+	size_t bad_quote;
+	bool error;
+	size_t error_offset;
+};
+
+#endif CsvParser_H
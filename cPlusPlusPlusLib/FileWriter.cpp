@@ -0,0 +1,347 @@
+/*
+* This is the cpp file for the FileWriter class of cPlusPlusPlusLib
+* cPPPLib - A library of functions that should be in the C++ Standard Library
+* (C) - Charles Machalow - MIT License
+*/
+
+#ifndef FileWriter_CPP
+#define FileWriter_CPP
+
+#include "FileWriter.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif //_WIN32
+
+// Alignment of the buffer and of the pieces handed to the OS (the usual page size)
+static const size_t FILE_WRITER_ALIGNMENT = 4096;
+
+/// <summary>
+/// Constructor for a FileWriter
+/// </summary>
+/// <param name="buffer_size">Bytes to gather before writing to the file, rounded up to a whole number of pages (Defaults to 1 MiB)</param>
+FileWriter::FileWriter(const size_t &buffer_size)
+	:
+#ifdef _WIN32
+	file_handle(INVALID_HANDLE_VALUE),
+#endif //_WIN32
+#ifdef __linux
+	fd(-1),
+#endif //__linux
+	buffer(nullptr), buffered(0), written(0), reserved(0)
+{
+	this->buffer_size = std::max((buffer_size + FILE_WRITER_ALIGNMENT - 1) / FILE_WRITER_ALIGNMENT, static_cast<size_t>(1)) * FILE_WRITER_ALIGNMENT;
+
+#ifdef _WIN32
+	buffer = static_cast<char *>(_aligned_malloc(this->buffer_size, FILE_WRITER_ALIGNMENT));
+#endif //_WIN32
+#ifdef __linux
+	void *allocated = nullptr;
+	if (posix_memalign(&allocated, FILE_WRITER_ALIGNMENT, this->buffer_size) == 0)
+	{
+		buffer = static_cast<char *>(allocated);
+	}
+#endif //__linux
+
+	if (buffer == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+}
+
+/// <summary>
+/// Destructor for a FileWriter. Writes out anything buffered and closes the file.
+/// </summary>
+FileWriter::~FileWriter()
+{
+	close();
+
+#ifdef _WIN32
+	_aligned_free(buffer);
+#endif //_WIN32
+#ifdef __linux
+	free(buffer);
+#endif //__linux
+}
+
+/// <summary>
+/// Creates (or truncates) a file for writing, closing any file already open.
+/// If expected_size is given, checks there is that much free space and reserves it, without changing the file's size.
+/// Linux: Uses open() and fallocate(FALLOC_FL_KEEP_SIZE). Filesystems that cannot reserve space just skip it.
+/// Windows: Uses CreateFileA() and SetFileInformationByHandle(FileAllocationInfo)
+/// </summary>
+/// <param name="path">Path to the file</param>
+/// <param name="expected_size">Number of bytes expected to be written. 0 means unknown (Defaults to 0)</param>
+/// <returns>True on success, On failure will print or perror(...) the reason then return false</returns>
+bool FileWriter::open(const std::string &path, const uint64_t &expected_size)
+{
+	close();
+
+	if (expected_size > 0)
+	{
+		uint64_t free_space = 0;
+		if (!UtilityFunctions::getFreeSpaceInBytes(free_space, FileWriter::directoryOf(path)))
+		{
+			return false;
+		}
+
+		if (free_space < expected_size)
+		{
+			std::cerr << "ERROR: " << path << " needs " << expected_size << " bytes, but only " << free_space << " are free" << std::endl;
+			return false;
+		}
+	}
+
+#ifdef _WIN32
+	file_handle = CreateFileA(path.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file_handle == INVALID_HANDLE_VALUE)
+	{
+		UtilityFunctions::cperror("CreateFileA() failed", false);
+		return false;
+	}
+
+	if (expected_size > 0)
+	{
+		FILE_ALLOCATION_INFO allocation;
+		allocation.AllocationSize.QuadPart = static_cast<LONGLONG>(expected_size);
+		if (!SetFileInformationByHandle(file_handle, FileAllocationInfo, &allocation, sizeof(allocation)))
+		{
+			UtilityFunctions::cperror("SetFileInformationByHandle() failed", false);
+			close();
+			return false;
+		}
+	}
+#endif //_WIN32
+#ifdef __linux
+	fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd < 0)
+	{
+		perror("open() failed");
+		return false;
+	}
+
+#ifdef FALLOC_FL_KEEP_SIZE
+	if (expected_size > 0 && fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(expected_size)) != 0 && errno != EOPNOTSUPP && errno != ENOSYS)
+	{
+		perror("fallocate() failed");
+		close();
+		return false;
+	}
+#endif //FALLOC_FL_KEEP_SIZE
+#endif //__linux
+
+	reserved = expected_size;
+	return true;
+}
+
+/// <summary>
+/// Writes bytes to the file.
+/// Small writes are gathered in the buffer. Large writes skip the buffer when it is empty.
+/// </summary>
+/// <param name="data">Pointer to the first byte</param>
+/// <param name="size">Number of bytes</param>
+/// <returns>True on success, On failure will do a perror(...) call then return false</returns>
+bool FileWriter::write(const char *data, const size_t &size)
+{
+	if (!isOpen())
+	{
+		return false;
+	}
+
+	size_t pos = 0;
+
+	// Top up a partly filled buffer first
+	if (buffered > 0)
+	{
+		pos = std::min(size, buffer_size - buffered);
+		memcpy(buffer + buffered, data, pos);
+		buffered += pos;
+
+		if (buffered == buffer_size && !flush())
+		{
+			return false;
+		}
+	}
+
+	// Write whole pages straight from data, leaving the rest for the buffer
+	if (buffered == 0 && size - pos >= buffer_size)
+	{
+		size_t direct = (size - pos) - (size - pos) % FILE_WRITER_ALIGNMENT;
+		if (!writeToFile(data + pos, direct))
+		{
+			return false;
+		}
+		pos += direct;
+	}
+
+	memcpy(buffer + buffered, data + pos, size - pos);
+	buffered += size - pos;
+	return true;
+}
+
+/// <summary>
+/// Writes the bytes of a StringView to the file
+/// </summary>
+/// <param name="str">The bytes to write</param>
+/// <returns>True on success, On failure will do a perror(...) call then return false</returns>
+bool FileWriter::write(const StringView &str)
+{
+	return write(str.data(), str.size());
+}
+
+/// <summary>
+/// Hands anything buffered to the OS. This does not wait for the OS to write it to disk.
+/// If the write fails, the bytes the OS did not take stay buffered so a later flush() can retry them.
+/// </summary>
+/// <returns>True on success, On failure will do a perror(...) call then return false</returns>
+bool FileWriter::flush()
+{
+	if (buffered == 0)
+	{
+		return true;
+	}
+
+	uint64_t written_before = written;
+	if (!writeToFile(buffer, buffered))
+	{
+		size_t taken = static_cast<size_t>(written - written_before);
+		memmove(buffer, buffer + taken, buffered - taken);
+		buffered -= taken;
+		return false;
+	}
+
+	buffered = 0;
+	return true;
+}
+
+/// <summary>
+/// Writes out anything buffered, gives back reserved space that went unused, and closes the file
+/// </summary>
+/// <returns>True on success (or if no file is open), On failure will do a perror(...) call then return false</returns>
+bool FileWriter::close()
+{
+	if (!isOpen())
+	{
+		return true;
+	}
+
+	bool ret = flush();
+
+#ifdef _WIN32
+	// NTFS gives back allocation past the end of the file when the last handle closes
+	if (!CloseHandle(file_handle))
+	{
+		UtilityFunctions::cperror("CloseHandle() failed", false);
+		ret = false;
+	}
+	file_handle = INVALID_HANDLE_VALUE;
+#endif //_WIN32
+#ifdef __linux
+	// Blocks reserved past the end of the file stay allocated until it is truncated
+	if (reserved > written && ftruncate(fd, static_cast<off_t>(written)) != 0)
+	{
+		perror("ftruncate() failed");
+		ret = false;
+	}
+
+	if (::close(fd) != 0)
+	{
+		perror("close() failed");
+		ret = false;
+	}
+	fd = -1;
+#endif //__linux
+
+	buffered = 0;
+	written = 0;
+	reserved = 0;
+	return ret;
+}
+
+/// <summary>
+/// Determines if a file is open
+/// </summary>
+/// <returns>True if open() succeeded and close() has not been called since</returns>
+bool FileWriter::isOpen() const
+{
+#ifdef _WIN32
+	return file_handle != INVALID_HANDLE_VALUE;
+#endif //_WIN32
+#ifdef __linux
+	return fd >= 0;
+#endif //__linux
+}
+
+/// <summary>
+/// Gets the number of bytes handed to the OS so far (not counting what is still buffered)
+/// </summary>
+/// <returns>Number of bytes written to the file</returns>
+uint64_t FileWriter::bytesWritten() const
+{
+	return written;
+}
+
+/// <summary>
+/// Writes bytes straight to the file, retrying on partial writes
+/// </summary>
+/// <param name="data">Pointer to the first byte</param>
+/// <param name="size">Number of bytes</param>
+/// <returns>True on success, On failure will do a perror(...) call then return false</returns>
+bool FileWriter::writeToFile(const char *data, const size_t &size)
+{
+	size_t pos = 0;
+
+	while (pos < size)
+	{
+#ifdef _WIN32
+		DWORD to_write = static_cast<DWORD>(std::min(size - pos, static_cast<size_t>(1) << 30));
+		DWORD count = 0;
+		if (!WriteFile(file_handle, data + pos, to_write, &count, NULL))
+		{
+			UtilityFunctions::cperror("WriteFile() failed", false);
+			return false;
+		}
+#endif //_WIN32
+#ifdef __linux
+		ssize_t count = ::write(fd, data + pos, size - pos);
+		if (count < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			perror("write() failed");
+			return false;
+		}
+#endif //__linux
+
+		pos += static_cast<size_t>(count);
+		written += static_cast<uint64_t>(count);
+	}
+
+	return true;
+}
+
+/// <summary>
+/// Gets the directory part of a path, for checking free space before the file exists
+/// </summary>
+/// <param name="path">Path to a file</param>
+/// <returns>The directory holding the file, with its trailing separator ("./" if path has no directory)</returns>
+std::string FileWriter::directoryOf(const std::string &path)
+{
+	size_t loc = path.find_last_of("/\\");
+	if (loc == std::string::npos)
+	{
+		return "./";
+	}
+
+	// Keep the separator: "a/" is never mistaken for a drive letter, and "C:\" is the drive's root rather than its current directory
+	return path.substr(0, loc + 1);
+}
+
+#endif FileWriter_CPP
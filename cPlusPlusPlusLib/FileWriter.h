@@ -0,0 +1,61 @@
+/*
+* This is the header file for the FileWriter class of cPlusPlusPlusLib
+* cPPPLib - A library of functions that should be in the C++ Standard Library
+* (C) - Charles Machalow - MIT License
+*/
+
+#ifndef FileWriter_H
+#define FileWriter_H
+
+#include <cstdint>
+#include <string>
+
+#include "StringView.h"
+#include "UtilityFunctions.h"
+
+#ifdef __linux
+#include <fcntl.h>
+#include <unistd.h>
+#endif //__linux
+
+/// <summary>
+/// Buffered file writer for large outputs.
+/// Space for the expected output is checked for and reserved up front, so a full disk fails at open() rather than part way through.
+/// Writes are gathered in a page aligned buffer and handed to the OS in large, page aligned pieces.
+/// </summary>
+class FileWriter
+{
+public:
+	FileWriter(const size_t &buffer_size = 1 << 20);
+	~FileWriter();
+
+	FileWriter(const FileWriter &) = delete;
+	FileWriter &operator=(const FileWriter &) = delete;
+
+	bool open(const std::string &path, const uint64_t &expected_size = 0);
+	bool write(const char *data, const size_t &size);
+	bool write(const StringView &str);
+	bool flush();
+	bool close();
+	bool isOpen() const;
+
+	uint64_t bytesWritten() const;
+
+private:
+	bool writeToFile(const char *data, const size_t &size);
+	static std::string directoryOf(const std::string &path);
+
+#ifdef _WIN32
+	HANDLE file_handle;
+#endif //_WIN32
+#ifdef __linux
+	int fd;
+#endif //__linux
+	char *buffer;
+	size_t buffer_size;
+	size_t buffered;
+	uint64_t written;
+	uint64_t reserved;
+};
+
+#endif FileWriter_H
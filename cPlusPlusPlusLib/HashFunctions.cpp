@@ -0,0 +1,265 @@
+/*
+* This is the cpp file for the HashFunctions class of cPlusPlusPlusLib
+* cPPPLib - A library of functions that should be in the C++ Standard Library
+* (C) - Charles Machalow - MIT License
+*/
+
+#ifndef HashFunctions_CPP
+#define HashFunctions_CPP
+
+#include "HashFunctions.h"
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif //_MSC_VER && _M_X64
+
+// Mixing constants (odd, high entropy 64 bit primes as used by wyhash)
+static const uint64_t HASH_P0 = 0xa0761d6478bd642fULL;
+static const uint64_t HASH_P1 = 0xe7037ed1a0b428dbULL;
+static const uint64_t HASH_P2 = 0x8ebc6af09c88c6e3ULL;
+
+/// <summary>
+/// Hashes a range of bytes
+/// </summary>
+/// <param name="data">Pointer to the first byte</param>
+/// <param name="size">Number of bytes</param>
+/// <param name="seed">Seed for the hash (Defaults to 0)</param>
+/// <returns>64 bit hash of the bytes</returns>
+uint64_t HashFunctions::hash(const void *data, const size_t &size, const uint64_t &seed)
+{
+	return hashImpl<false>(static_cast<const unsigned char *>(data), size, seed);
+}
+
+/// <summary>
+/// Hashes the given std::string
+/// </summary>
+/// <param name="original_str">The original std::string</param>
+/// <param name="seed">Seed for the hash (Defaults to 0)</param>
+/// <returns>64 bit hash of original_str</returns>
+uint64_t HashFunctions::hash(const std::string &original_str, const uint64_t &seed)
+{
+	return hashImpl<false>(reinterpret_cast<const unsigned char *>(original_str.data()), original_str.size(), seed);
+}
+
+/// <summary>
+/// Hashes a range of chars as if it had been lowercased first, without making a lowercase copy.
+/// Only ASCII letters are folded.
+/// </summary>
+/// <param name="data">Pointer to the first char</param>
+/// <param name="size">Number of chars</param>
+/// <param name="seed">Seed for the hash (Defaults to 0)</param>
+/// <returns>The same value as hash() of the lowercased chars</returns>
+uint64_t HashFunctions::hashCaseInsensitive(const char *data, const size_t &size, const uint64_t &seed)
+{
+	return hashImpl<true>(reinterpret_cast<const unsigned char *>(data), size, seed);
+}
+
+/// <summary>
+/// Hashes the given std::string as if it had been lowercased first, without making a lowercase copy.
+/// Only ASCII letters are folded.
+/// </summary>
+/// <param name="original_str">The original std::string</param>
+/// <param name="seed">Seed for the hash (Defaults to 0)</param>
+/// <returns>The same value as hash(StringFunctions::toLowerCase(original_str))</returns>
+uint64_t HashFunctions::hashCaseInsensitive(const std::string &original_str, const uint64_t &seed)
+{
+	return hashImpl<true>(reinterpret_cast<const unsigned char *>(original_str.data()), original_str.size(), seed);
+}
+
+/// <summary>
+/// Hashes many std::strings at once.
+/// Strings are processed four at a time with independent states so their block loops overlap in the CPU.
+/// </summary>
+/// <param name="strs">The std::strings to hash</param>
+/// <param name="seed">Seed for the hash (Defaults to 0)</param>
+/// <returns>std::vector<uint64_t> where each item is hash() of the matching item in strs</returns>
+std::vector<uint64_t> HashFunctions::hashMany(const std::vector<std::string> &strs, const uint64_t &seed)
+{
+	const size_t LANES = 4;
+	std::vector<uint64_t> ret_vec(strs.size());
+	size_t i = 0;
+
+	for (; i + LANES <= strs.size(); i += LANES)
+	{
+		const unsigned char *ptrs[LANES];
+		size_t remaining[LANES];
+		uint64_t states[LANES];
+		size_t common_blocks = std::numeric_limits<size_t>::max();
+
+		for (size_t lane = 0; lane < LANES; lane++)
+		{
+			const std::string &cur = strs[i + lane];
+			ptrs[lane] = reinterpret_cast<const unsigned char *>(cur.data());
+			remaining[lane] = cur.size();
+			states[lane] = seed ^ mix(seed ^ HASH_P0, HASH_P1);
+			common_blocks = std::min(common_blocks, cur.empty() ? 0 : (cur.size() - 1) / 16);
+		}
+
+		// Blocks every lane has in common, interleaved
+		for (size_t block = 0; block < common_blocks; block++)
+		{
+			for (size_t lane = 0; lane < LANES; lane++)
+			{
+				states[lane] = mix(load64(ptrs[lane]) ^ HASH_P1, load64(ptrs[lane] + 8) ^ states[lane]);
+				ptrs[lane] += 16;
+			}
+		}
+
+		// Whatever is left in each lane
+		for (size_t lane = 0; lane < LANES; lane++)
+		{
+			size_t rem = remaining[lane] - common_blocks * 16;
+			while (rem > 16)
+			{
+				states[lane] = mix(load64(ptrs[lane]) ^ HASH_P1, load64(ptrs[lane] + 8) ^ states[lane]);
+				ptrs[lane] += 16;
+				rem -= 16;
+			}
+
+			uint64_t a = loadTail(ptrs[lane], std::min(rem, static_cast<size_t>(8)));
+			uint64_t b = rem > 8 ? loadTail(ptrs[lane] + 8, rem - 8) : 0;
+			ret_vec[i + lane] = finish(states[lane], a, b, remaining[lane]);
+		}
+	}
+
+	for (; i < strs.size(); i++)
+	{
+		ret_vec[i] = HashFunctions::hash(strs[i], seed);
+	}
+
+	return ret_vec;
+}
+
+/// <summary>
+/// Multiplies a and b into 128 bits and folds the halves together
+/// </summary>
+/// <param name="a">First 64 bit value</param>
+/// <param name="b">Second 64 bit value</param>
+/// <returns>Low 64 bits of the product XOR high 64 bits of the product</returns>
+uint64_t HashFunctions::mix(const uint64_t &a, const uint64_t &b)
+{
+#if defined(__SIZEOF_INT128__)
+	unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+	return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	uint64_t high = 0;
+	uint64_t low = _umul128(a, b, &high);
+	return low ^ high;
+#else
+	uint64_t a_lo = a & 0xFFFFFFFF;
+	uint64_t a_hi = a >> 32;
+	uint64_t b_lo = b & 0xFFFFFFFF;
+	uint64_t b_hi = b >> 32;
+
+	uint64_t lo_lo = a_lo * b_lo;
+	uint64_t hi_lo = a_hi * b_lo;
+	uint64_t lo_hi = a_lo * b_hi;
+	uint64_t hi_hi = a_hi * b_hi;
+
+	uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+	uint64_t high = hi_hi + (hi_lo >> 32) + (cross >> 32);
+	uint64_t low = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+	return low ^ high;
+#endif
+}
+
+/// <summary>
+/// Reads 8 (possibly unaligned) bytes as a uint64_t
+/// </summary>
+/// <param name="data">Pointer to the first byte</param>
+/// <returns>The 8 bytes as a uint64_t</returns>
+uint64_t HashFunctions::load64(const unsigned char *data)
+{
+	uint64_t word;
+	memcpy(&word, data, sizeof(word));
+	return word;
+}
+
+/// <summary>
+/// Reads up to 8 bytes as a uint64_t, leaving the unused bytes as 0
+/// </summary>
+/// <param name="data">Pointer to the first byte</param>
+/// <param name="size">Number of bytes to read (0 to 8)</param>
+/// <returns>The bytes as a uint64_t</returns>
+uint64_t HashFunctions::loadTail(const unsigned char *data, const size_t &size)
+{
+	uint64_t word = 0;
+	if (size != 0)
+	{
+		memcpy(&word, data, size);
+	}
+	return word;
+}
+
+/// <summary>
+/// Lowercases every ASCII letter in the 8 bytes of word at once.
+/// Bytes with the high bit set are left alone.
+/// </summary>
+/// <param name="word">8 chars packed into a uint64_t</param>
+/// <returns>word with 'A'-'Z' replaced by 'a'-'z'</returns>
+uint64_t HashFunctions::foldAsciiCase(const uint64_t &word)
+{
+	const uint64_t ONES = 0x0101010101010101ULL;
+	const uint64_t HIGH_BITS = 0x8080808080808080ULL;
+
+	uint64_t low7 = word & ~HIGH_BITS;
+	uint64_t at_least_a = low7 + ONES * (0x80 - 'A');
+	uint64_t above_z = low7 + ONES * (0x80 - 'Z' - 1);
+	uint64_t is_upper = at_least_a & ~above_z & ~word & HIGH_BITS;
+
+	// 0x80 >> 2 is 0x20, the bit that separates upper from lower case
+	return word | (is_upper >> 2);
+}
+
+/// <summary>
+/// Final avalanche for a hash
+/// </summary>
+/// <param name="state">The running state after all full blocks</param>
+/// <param name="a">First 8 bytes of the final (up to 16 byte) block</param>
+/// <param name="b">Second 8 bytes of the final block</param>
+/// <param name="size">Total number of bytes hashed</param>
+/// <returns>The finished hash</returns>
+uint64_t HashFunctions::finish(const uint64_t &state, const uint64_t &a, const uint64_t &b, const size_t &size)
+{
+	return mix(HASH_P2 ^ static_cast<uint64_t>(size), mix(a ^ HASH_P1, b ^ state));
+}
+
+/// <summary>
+/// Shared hash loop. Consumes 16 bytes per step while more than 16 bytes remain, then finishes on the rest.
+/// </summary>
+/// <param name="data">Pointer to the first byte</param>
+/// <param name="size">Number of bytes</param>
+/// <param name="seed">Seed for the hash</param>
+/// <returns>64 bit hash of the bytes (ASCII case folded if FoldCase)</returns>
+template <bool FoldCase> uint64_t HashFunctions::hashImpl(const unsigned char *data, const size_t &size, const uint64_t &seed)
+{
+	uint64_t state = seed ^ mix(seed ^ HASH_P0, HASH_P1);
+	const unsigned char *ptr = data;
+	size_t rem = size;
+
+	while (rem > 16)
+	{
+		uint64_t a = load64(ptr);
+		uint64_t b = load64(ptr + 8);
+		if (FoldCase)
+		{
+			a = foldAsciiCase(a);
+			b = foldAsciiCase(b);
+		}
+		state = mix(a ^ HASH_P1, b ^ state);
+		ptr += 16;
+		rem -= 16;
+	}
+
+	uint64_t a = loadTail(ptr, std::min(rem, static_cast<size_t>(8)));
+	uint64_t b = rem > 8 ? loadTail(ptr + 8, rem - 8) : 0;
+	if (FoldCase)
+	{
+		a = foldAsciiCase(a);
+		b = foldAsciiCase(b);
+	}
+
+	return finish(state, a, b, size);
+}
+
+#endif HashFunctions_CPP
@@ -0,0 +1,100 @@
+/*
+* This is the header file for the HashFunctions class of cPlusPlusPlusLib
+* cPPPLib - A library of functions that should be in the C++ Standard Library
+* (C) - Charles Machalow - MIT License
+*/
+
+#ifndef HashFunctions_H
+#define HashFunctions_H
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/// <summary>
+/// Class for fast non-cryptographic hashing of std::strings and std::vectors.
+/// Hashes are stable for a given seed within a build, but are not meant to be persisted.
+/// </summary>
+class HashFunctions
+{
+public:
+	static uint64_t hash(const void *data, const size_t &size, const uint64_t &seed = 0);
+	static uint64_t hash(const std::string &original_str, const uint64_t &seed = 0);
+	static uint64_t hashCaseInsensitive(const char *data, const size_t &size, const uint64_t &seed = 0);
+	static uint64_t hashCaseInsensitive(const std::string &original_str, const uint64_t &seed = 0);
+	static std::vector<uint64_t> hashMany(const std::vector<std::string> &strs, const uint64_t &seed = 0);
+
+	/// <summary>
+	/// Hashes the contiguous contents of the given std::vector
+	/// </summary>
+	/// <param name="vec">The std::vector<T> to hash. T must be trivially copyable</param>
+	/// <param name="seed">Seed for the hash (Defaults to 0)</param>
+	/// <returns>64 bit hash of the bytes held by vec</returns>
+	template <typename T> static uint64_t hash(const std::vector<T> &vec, const uint64_t &seed = 0)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "HashFunctions::hash requires a std::vector of a trivially copyable type");
+		return hash(vec.data(), vec.size() * sizeof(T), seed);
+	}
+
+	/// <summary>
+	/// Hasher for std::unordered_map / std::unordered_set keyed by std::string
+	/// </summary>
+	struct StringHash
+	{
+		size_t operator()(const std::string &str) const
+		{
+			return static_cast<size_t>(HashFunctions::hash(str));
+		}
+	};
+
+	/// <summary>
+	/// Hasher for std::unordered_map / std::unordered_set keyed by std::string where case does not matter.
+	/// Use along with CaseInsensitiveEqual.
+	/// </summary>
+	struct CaseInsensitiveHash
+	{
+		size_t operator()(const std::string &str) const
+		{
+			return static_cast<size_t>(HashFunctions::hashCaseInsensitive(str));
+		}
+	};
+
+	/// <summary>
+	/// Equality for std::unordered_map / std::unordered_set keyed by std::string where case does not matter.
+	/// </summary>
+	struct CaseInsensitiveEqual
+	{
+		bool operator()(const std::string &lhs, const std::string &rhs) const
+		{
+			if (lhs.size() != rhs.size())
+			{
+				return false;
+			}
+
+			for (size_t i = 0; i < lhs.size(); i++)
+			{
+				if (tolower(static_cast<unsigned char>(lhs[i])) != tolower(static_cast<unsigned char>(rhs[i])))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+	};
+
+private:
+	static uint64_t mix(const uint64_t &a, const uint64_t &b);
+	static uint64_t load64(const unsigned char *data);
+	static uint64_t loadTail(const unsigned char *data, const size_t &size);
+	static uint64_t foldAsciiCase(const uint64_t &word);
+	static uint64_t finish(const uint64_t &state, const uint64_t &a, const uint64_t &b, const size_t &size);
+	template <bool FoldCase> static uint64_t hashImpl(const unsigned char *data, const size_t &size, const uint64_t &seed);
+};
+
+#endif HashFunctions_H
@@ -0,0 +1,653 @@
+/*
+* This is the cpp file for the MappedFile class of cPlusPlusPlusLib
+* cPPPLib - A library of functions that should be in the C++ Standard Library
+* (C) - Charles Machalow - MIT License
+*/
+
+#ifndef MappedFile_CPP
+#define MappedFile_CPP
+
+#include "MappedFile.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+/// <summary>
+/// Constructor for a MappedFile that maps nothing yet
+/// </summary>
+MappedFile::MappedFile()
+	:
+#ifdef _WIN32
+	file_handle(INVALID_HANDLE_VALUE), mapping_handle(NULL),
+#endif //_WIN32
+#ifdef __linux
+	fd(-1),
+#endif //__linux
+	mapped(nullptr), mapped_size(0), writable(false), is_open(false)
+{
+}
+
+/// <summary>
+/// Constructor for a MappedFile that maps the given file. Check isOpen() for success.
+/// </summary>
+/// <param name="path">Path to the file</param>
+/// <param name="writable">If True, map for reading and writing, otherwise read-only (Defaults to False)</param>
+/// <param name="huge_pages">If True, ask for huge pages (Defaults to False). See open()</param>
+MappedFile::MappedFile(const std::string &path, const bool &writable, const bool &huge_pages) : MappedFile()
+{
+	open(path, writable, huge_pages);
+}
+
+/// <summary>
+/// Destructor for a MappedFile. Unmaps the file.
+/// </summary>
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+/// <summary>
+/// Move constructor for a MappedFile. other is left mapping nothing.
+/// </summary>
+/// <param name="other">The MappedFile to take the mapping from</param>
+MappedFile::MappedFile(MappedFile &&other) : MappedFile()
+{
+	takeFrom(other);
+}
+
+/// <summary>
+/// Move assignment for a MappedFile. Unmaps this MappedFile's file, then takes other's mapping.
+/// </summary>
+/// <param name="other">The MappedFile to take the mapping from</param>
+/// <returns>This MappedFile</returns>
+MappedFile &MappedFile::operator=(MappedFile &&other)
+{
+	if (this != &other)
+	{
+		close();
+		takeFrom(other);
+	}
+	return *this;
+}
+
+/// <summary>
+/// Maps a whole file into memory, unmapping any file already mapped.
+/// An empty file opens successfully with a null data() and a size() of 0.
+/// Linux: Uses open() and mmap(). huge_pages asks for transparent huge pages with madvise(MADV_HUGEPAGE),
+///  which the kernel only honors for filesystems that support them.
+/// Windows: Uses CreateFileA(), CreateFileMappingA() and MapViewOfFile(). huge_pages is ignored,
+///  since large pages cannot back file mappings.
+/// </summary>
+/// <param name="path">Path to the file</param>
+/// <param name="writable">If True, map for reading and writing, otherwise read-only (Defaults to False)</param>
+/// <param name="huge_pages">If True, ask for huge pages (Defaults to False)</param>
+/// <returns>True on success, On failure will do a perror(...) call then return false</returns>
+bool MappedFile::open(const std::string &path, const bool &writable, const bool &huge_pages)
+{
+	close();
+	this->writable = writable;
+
+#ifdef _WIN32
+	file_handle = CreateFileA(path.c_str(), writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file_handle == INVALID_HANDLE_VALUE)
+	{
+		UtilityFunctions::cperror("CreateFileA() failed", false);
+		return false;
+	}
+
+	// Pipes and devices report a size of 0 and can't be mapped
+	if (GetFileType(file_handle) != FILE_TYPE_DISK)
+	{
+		std::cerr << "ERROR: " << path << " is not a regular file" << std::endl;
+		close();
+		return false;
+	}
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file_handle, &file_size))
+	{
+		UtilityFunctions::cperror("GetFileSizeEx() failed", false);
+		close();
+		return false;
+	}
+
+	mapped_size = static_cast<size_t>(file_size.QuadPart);
+	if (mapped_size > 0)
+	{
+		mapping_handle = CreateFileMappingA(file_handle, NULL, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, NULL);
+		if (mapping_handle == NULL)
+		{
+			UtilityFunctions::cperror("CreateFileMappingA() failed", false);
+			close();
+			return false;
+		}
+
+		mapped = static_cast<char *>(MapViewOfFile(mapping_handle, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0));
+		if (mapped == nullptr)
+		{
+			UtilityFunctions::cperror("MapViewOfFile() failed", false);
+			close();
+			return false;
+		}
+	}
+#endif //_WIN32
+#ifdef __linux
+	// O_NONBLOCK keeps a FIFO without a writer from blocking here before it is rejected below
+	fd = ::open(path.c_str(), (writable ? O_RDWR : O_RDONLY) | O_CLOEXEC | O_NONBLOCK);
+	if (fd < 0)
+	{
+		perror("open() failed");
+		return false;
+	}
+
+	struct stat file_stat;
+	if (fstat(fd, &file_stat) != 0)
+	{
+		perror("fstat() failed");
+		close();
+		return false;
+	}
+
+	// Pipes, sockets and devices report a size of 0 and can't be mapped
+	if (!S_ISREG(file_stat.st_mode))
+	{
+		std::cerr << "ERROR: " << path << " is not a regular file" << std::endl;
+		close();
+		return false;
+	}
+
+	mapped_size = static_cast<size_t>(file_stat.st_size);
+	if (mapped_size > 0)
+	{
+		void *address = mmap(nullptr, mapped_size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+		if (address == MAP_FAILED)
+		{
+			perror("mmap() failed");
+			close();
+			return false;
+		}
+		mapped = static_cast<char *>(address);
+
+#ifdef MADV_HUGEPAGE
+		if (huge_pages)
+		{
+			// Only a hint: most filesystems will just keep using normal pages
+			madvise(mapped, mapped_size, MADV_HUGEPAGE);
+		}
+#endif //MADV_HUGEPAGE
+	}
+#endif //__linux
+
+	(void)huge_pages;
+	is_open = true;
+	return true;
+}
+
+/// <summary>
+/// Unmaps the file, if any. Changes made through a writable mapping are written back by the OS.
+/// </summary>
+void MappedFile::close()
+{
+#ifdef _WIN32
+	if (mapped != nullptr)
+	{
+		UnmapViewOfFile(mapped);
+	}
+	if (mapping_handle != NULL)
+	{
+		CloseHandle(mapping_handle);
+		mapping_handle = NULL;
+	}
+	if (file_handle != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(file_handle);
+		file_handle = INVALID_HANDLE_VALUE;
+	}
+#endif //_WIN32
+#ifdef __linux
+	if (mapped != nullptr)
+	{
+		munmap(mapped, mapped_size);
+	}
+	if (fd >= 0)
+	{
+		::close(fd);
+		fd = -1;
+	}
+#endif //__linux
+
+	mapped = nullptr;
+	mapped_size = 0;
+	is_open = false;
+}
+
+/// <summary>
+/// Determines if a file is mapped
+/// </summary>
+/// <returns>True if open() succeeded and close() has not been called since</returns>
+bool MappedFile::isOpen() const
+{
+	return is_open;
+}
+
+/// <summary>
+/// Tells the OS how part of the mapping is about to be used, so it can read ahead or drop pages accordingly.
+/// Linux: Uses madvise()
+/// Windows: Only AccessHint::WillNeed does anything, using PrefetchVirtualMemory() (Windows 8 and later)
+/// </summary>
+/// <param name="hint">How the bytes will be used</param>
+/// <param name="offset">Offset of the first byte the hint is for (Defaults to 0)</param>
+/// <param name="length">Number of bytes the hint is for. 0 means up to the end of the file (Defaults to 0)</param>
+/// <returns>True on success (or if there is nothing mapped), On failure will do a perror(...) call then return false</returns>
+bool MappedFile::advise(const AccessHint &hint, const size_t &offset, const size_t &length)
+{
+	if (mapped == nullptr || offset >= mapped_size)
+	{
+		return true;
+	}
+
+	size_t count = (length == 0 || length > mapped_size - offset) ? mapped_size - offset : length;
+
+#ifdef _WIN32
+#if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0602
+	if (hint == AccessHint::WillNeed)
+	{
+		WIN32_MEMORY_RANGE_ENTRY range;
+		range.VirtualAddress = mapped + offset;
+		range.NumberOfBytes = count;
+		if (!PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0))
+		{
+			UtilityFunctions::cperror("PrefetchVirtualMemory() failed", false);
+			return false;
+		}
+	}
+#endif //_WIN32_WINNT >= 0x0602
+	(void)hint;
+	(void)count;
+	return true;
+#endif //_WIN32
+#ifdef __linux
+	// madvise() needs a page aligned address
+	size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	size_t aligned_offset = offset - offset % page_size;
+
+	int advice = MADV_NORMAL;
+	switch (hint)
+	{
+	case AccessHint::Sequential:
+		advice = MADV_SEQUENTIAL;
+		break;
+	case AccessHint::Random:
+		advice = MADV_RANDOM;
+		break;
+	case AccessHint::WillNeed:
+		advice = MADV_WILLNEED;
+		break;
+	default:
+		break;
+	}
+
+	if (madvise(mapped + aligned_offset, count + (offset - aligned_offset), advice) != 0)
+	{
+		perror("madvise() failed");
+		return false;
+	}
+	return true;
+#endif //__linux
+}
+
+/// <summary>
+/// Writes changes made through a writable mapping back to the file, waiting until they are done.
+/// Linux: Uses msync()
+/// Windows: Uses FlushViewOfFile() and FlushFileBuffers()
+/// </summary>
+/// <returns>True on success (or if there is nothing to write), On failure will do a perror(...) call then return false</returns>
+bool MappedFile::flush()
+{
+	if (mapped == nullptr || !writable)
+	{
+		return true;
+	}
+
+#ifdef _WIN32
+	if (!FlushViewOfFile(mapped, 0) || !FlushFileBuffers(file_handle))
+	{
+		UtilityFunctions::cperror("FlushViewOfFile() failed", false);
+		return false;
+	}
+#endif //_WIN32
+#ifdef __linux
+	if (msync(mapped, mapped_size, MS_SYNC) != 0)
+	{
+		perror("msync() failed");
+		return false;
+	}
+#endif //__linux
+
+	return true;
+}
+
+/// <summary>
+/// Gets the mapped bytes
+/// </summary>
+/// <returns>Pointer to the first byte of the file, or nullptr if nothing (or an empty file) is mapped</returns>
+const char *MappedFile::data() const
+{
+	return mapped;
+}
+
+/// <summary>
+/// Gets the mapped bytes for writing. Only write through this if the file was opened writable.
+/// </summary>
+/// <returns>Pointer to the first byte of the file, or nullptr if nothing (or an empty file) is mapped</returns>
+char *MappedFile::data()
+{
+	return mapped;
+}
+
+/// <summary>
+/// Gets the size of the mapped file
+/// </summary>
+/// <returns>Size of the file in bytes</returns>
+size_t MappedFile::size() const
+{
+	return mapped_size;
+}
+
+/// <summary>
+/// Gets a view of the whole mapped file
+/// </summary>
+/// <returns>StringView of the file's bytes, valid until the file is closed</returns>
+StringView MappedFile::view() const
+{
+	return StringView(mapped, mapped_size);
+}
+
+/// <summary>
+/// Takes the mapping and handles from another MappedFile, leaving it mapping nothing
+/// </summary>
+/// <param name="other">The MappedFile to take from</param>
+void MappedFile::takeFrom(MappedFile &other)
+{
+#ifdef _WIN32
+	file_handle = other.file_handle;
+	mapping_handle = other.mapping_handle;
+	other.file_handle = INVALID_HANDLE_VALUE;
+	other.mapping_handle = NULL;
+#endif //_WIN32
+#ifdef __linux
+	fd = other.fd;
+	other.fd = -1;
+#endif //__linux
+	mapped = other.mapped;
+	mapped_size = other.mapped_size;
+	writable = other.writable;
+	is_open = other.is_open;
+
+	other.mapped = nullptr;
+	other.mapped_size = 0;
+	other.is_open = false;
+}
+
+/// <summary>
+/// Constructor for a ChunkedFileReader
+/// </summary>
+/// <param name="chunk_size">Number of bytes to read per chunk (Defaults to 1 MiB)</param>
+ChunkedFileReader::ChunkedFileReader(const size_t &chunk_size)
+	:
+#ifdef _WIN32
+	file_handle(INVALID_HANDLE_VALUE),
+#endif //_WIN32
+#ifdef __linux
+	fd(-1),
+#endif //__linux
+	chunk_size(std::max(chunk_size, static_cast<size_t>(1))), leftover_begin(0), leftover_end(0), offset(0), file_size(0), error(false)
+{
+}
+
+/// <summary>
+/// Destructor for a ChunkedFileReader. Closes the file.
+/// </summary>
+ChunkedFileReader::~ChunkedFileReader()
+{
+	close();
+}
+
+/// <summary>
+/// Opens a file for reading from the start, closing any file already open.
+/// Linux: Uses open() and tells the kernel the file will be read sequentially with posix_fadvise()
+/// Windows: Uses CreateFileA() with FILE_FLAG_SEQUENTIAL_SCAN
+/// </summary>
+/// <param name="path">Path to the file</param>
+/// <returns>True on success, On failure will do a perror(...) call then return false</returns>
+bool ChunkedFileReader::open(const std::string &path)
+{
+	close();
+
+#ifdef _WIN32
+	file_handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file_handle == INVALID_HANDLE_VALUE)
+	{
+		UtilityFunctions::cperror("CreateFileA() failed", false);
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file_handle, &size))
+	{
+		UtilityFunctions::cperror("GetFileSizeEx() failed", false);
+		close();
+		return false;
+	}
+	file_size = static_cast<uint64_t>(size.QuadPart);
+#endif //_WIN32
+#ifdef __linux
+	fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+	{
+		perror("open() failed");
+		return false;
+	}
+
+	struct stat file_stat;
+	if (fstat(fd, &file_stat) != 0)
+	{
+		perror("fstat() failed");
+		close();
+		return false;
+	}
+	file_size = static_cast<uint64_t>(file_stat.st_size);
+
+	posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif //__linux
+
+	return true;
+}
+
+/// <summary>
+/// Closes the file, if any
+/// </summary>
+void ChunkedFileReader::close()
+{
+#ifdef _WIN32
+	if (file_handle != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(file_handle);
+		file_handle = INVALID_HANDLE_VALUE;
+	}
+#endif //_WIN32
+#ifdef __linux
+	if (fd >= 0)
+	{
+		::close(fd);
+		fd = -1;
+	}
+#endif //__linux
+
+	leftover_begin = 0;
+	leftover_end = 0;
+	offset = 0;
+	file_size = 0;
+	error = false;
+}
+
+/// <summary>
+/// Determines if a file is open
+/// </summary>
+/// <returns>True if open() succeeded and close() has not been called since</returns>
+bool ChunkedFileReader::isOpen() const
+{
+#ifdef _WIN32
+	return file_handle != INVALID_HANDLE_VALUE;
+#endif //_WIN32
+#ifdef __linux
+	return fd >= 0;
+#endif //__linux
+}
+
+/// <summary>
+/// Determines if next() stopped because of a read error rather than the end of the file
+/// </summary>
+/// <returns>True if a read failed</returns>
+bool ChunkedFileReader::failed() const
+{
+	return error;
+}
+
+/// <summary>
+/// Gets the size of the file when it was opened
+/// </summary>
+/// <returns>Size of the file in bytes</returns>
+uint64_t ChunkedFileReader::size() const
+{
+	return file_size;
+}
+
+/// <summary>
+/// Reads the next chunk of the file.
+/// With whole_lines, each chunk ends just after its last line feed and the partial line is carried into the next chunk,
+/// so no line is split across chunks unless a single line is longer than a chunk.
+/// </summary>
+/// <param name="chunk">StringView, passed by reference. Gets the chunk, valid until the next call to next() or close()</param>
+/// <param name="whole_lines">If True, only hand out whole lines (Defaults to False)</param>
+/// <returns>True if a chunk was read, False at the end of the file or on a read error (see failed())</returns>
+bool ChunkedFileReader::next(StringView &chunk, const bool &whole_lines)
+{
+	chunk = StringView();
+	if (!isOpen() || error)
+	{
+		return false;
+	}
+
+	// Move the partial line from the last chunk to the front
+	size_t carried = leftover_end - leftover_begin;
+	if (carried > 0 && leftover_begin > 0)
+	{
+		memmove(buffer.data(), buffer.data() + leftover_begin, carried);
+	}
+	leftover_begin = 0;
+	leftover_end = 0;
+
+	if (buffer.size() < carried + chunk_size)
+	{
+		buffer.resize(carried + chunk_size);
+	}
+
+	size_t bytes_read = 0;
+	if (!readAt(offset, buffer.data() + carried, chunk_size, bytes_read))
+	{
+		error = true;
+		return false;
+	}
+	offset += bytes_read;
+
+	size_t filled = carried + bytes_read;
+	if (filled == 0)
+	{
+		return false;
+	}
+
+	size_t chunk_end = filled;
+	if (whole_lines && bytes_read > 0)
+	{
+		const char *last_line_feed = nullptr;
+		for (size_t i = filled; i > 0; i--)
+		{
+			if (buffer[i - 1] == '\n')
+			{
+				last_line_feed = buffer.data() + i - 1;
+				break;
+			}
+		}
+
+		if (last_line_feed != nullptr)
+		{
+			chunk_end = last_line_feed - buffer.data() + 1;
+			leftover_begin = chunk_end;
+			leftover_end = filled;
+		}
+	}
+
+	chunk = StringView(buffer.data(), chunk_end);
+	return true;
+}
+
+/// <summary>
+/// Reads bytes from a given offset without moving the position used by next()
+/// Linux: Uses pread()
+/// Windows: Uses ReadFile() with an OVERLAPPED offset
+/// </summary>
+/// <param name="file_offset">Offset in the file to read from</param>
+/// <param name="buf">Buffer for the bytes</param>
+/// <param name="count">Number of bytes to read</param>
+/// <param name="bytes_read">size_t, passed by reference. Gets the number of bytes read, less than count only at the end of the file</param>
+/// <returns>True on success, On failure will do a perror(...) call then return false</returns>
+bool ChunkedFileReader::readAt(const uint64_t &file_offset, char *buf, const size_t &count, size_t &bytes_read) const
+{
+	bytes_read = 0;
+
+	while (bytes_read < count)
+	{
+		uint64_t position = file_offset + bytes_read;
+#ifdef _WIN32
+		OVERLAPPED overlapped = {};
+		overlapped.Offset = static_cast<DWORD>(position & 0xFFFFFFFF);
+		overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+
+		DWORD to_read = static_cast<DWORD>(std::min(count - bytes_read, static_cast<size_t>(1) << 30));
+		DWORD got = 0;
+		if (!ReadFile(file_handle, buf + bytes_read, to_read, &got, &overlapped))
+		{
+			if (GetLastError() == ERROR_HANDLE_EOF)
+			{
+				break;
+			}
+			UtilityFunctions::cperror("ReadFile() failed", false);
+			return false;
+		}
+#endif //_WIN32
+#ifdef __linux
+		ssize_t got = pread(fd, buf + bytes_read, count - bytes_read, static_cast<off_t>(position));
+		if (got < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			perror("pread() failed");
+			return false;
+		}
+#endif //__linux
+
+		if (got == 0)
+		{
+			break;
+		}
+		bytes_read += static_cast<size_t>(got);
+	}
+
+	return true;
+}
+
+#endif MappedFile_CPP
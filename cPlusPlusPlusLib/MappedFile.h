@@ -0,0 +1,118 @@
+/*
+* This is the header file for the MappedFile class of cPlusPlusPlusLib
+* cPPPLib - A library of functions that should be in the C++ Standard Library
+* (C) - Charles Machalow - MIT License
+*/
+
+#ifndef MappedFile_H
+#define MappedFile_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "StringView.h"
+#include "UtilityFunctions.h"
+
+#ifdef __linux
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif //__linux
+
+/// <summary>
+/// RAII memory mapping of a whole file.
+/// Read-only mappings hand the file's bytes straight to the string functions with no copying.
+/// Read-write mappings change the file in place, but cannot change its size.
+/// </summary>
+class MappedFile
+{
+public:
+	/// <summary>
+	/// How the mapped bytes are about to be used, passed on to the OS as a paging hint
+	/// </summary>
+	enum class AccessHint
+	{
+		Normal,
+		Sequential,
+		Random,
+		WillNeed
+	};
+
+	MappedFile();
+	MappedFile(const std::string &path, const bool &writable = false, const bool &huge_pages = false);
+	~MappedFile();
+
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+	MappedFile(MappedFile &&other);
+	MappedFile &operator=(MappedFile &&other);
+
+	bool open(const std::string &path, const bool &writable = false, const bool &huge_pages = false);
+	void close();
+	bool isOpen() const;
+
+	bool advise(const AccessHint &hint, const size_t &offset = 0, const size_t &length = 0);
+	bool flush();
+
+	const char *data() const;
+	char *data();
+	size_t size() const;
+	StringView view() const;
+
+private:
+	void takeFrom(MappedFile &other);
+
+#ifdef _WIN32
+	HANDLE file_handle;
+	HANDLE mapping_handle;
+#endif //_WIN32
+#ifdef __linux
+	int fd;
+#endif //__linux
+	char *mapped;
+	size_t mapped_size;
+	bool writable;
+	bool is_open;
+};
+
+/// <summary>
+/// Reads a file front to back in fixed size chunks with positional reads.
+/// The fallback for when a file cannot be mapped (pipes, files too big for the address space, network filesystems).
+/// </summary>
+class ChunkedFileReader
+{
+public:
+	ChunkedFileReader(const size_t &chunk_size = 1 << 20);
+	~ChunkedFileReader();
+
+	ChunkedFileReader(const ChunkedFileReader &) = delete;
+	ChunkedFileReader &operator=(const ChunkedFileReader &) = delete;
+
+	bool open(const std::string &path);
+	void close();
+	bool isOpen() const;
+	bool failed() const;
+	uint64_t size() const;
+
+	bool next(StringView &chunk, const bool &whole_lines = false);
+	bool readAt(const uint64_t &file_offset, char *buf, const size_t &count, size_t &bytes_read) const;
+
+private:
+#ifdef _WIN32
+	HANDLE file_handle;
+#endif //_WIN32
+#ifdef __linux
+	int fd;
+#endif //__linux
+	std::vector<char> buffer;
+	size_t chunk_size;
+	size_t leftover_begin;
+	size_t leftover_end;
+	uint64_t offset;
+	uint64_t file_size;
+	bool error;
+};
+
+#endif MappedFile_H
@@ -0,0 +1,591 @@
+/*
+* This is the cpp file for the NumberFunctions class of cPlusPlusPlusLib
+* cPPPLib - A library of functions that should be in the C++ Standard Library
+* (C) - Charles Machalow - MIT License
+*/
+
+#ifndef NumberFunctions_CPP
+#define NumberFunctions_CPP
+
+#include "NumberFunctions.h"
+#include "UtilityFunctions.h"
+
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <locale.h>
+
+#if defined(__APPLE__)
+#include <xlocale.h>
+#endif //__APPLE__
+
+// The SWAR digit parser reads memory as a little endian word
+static const bool NUMBER_LITTLE_ENDIAN = UtilityFunctions::isLittleEndian();
+
+// Powers of 10 that are exactly representable as a double
+static const double EXACT_POWERS_OF_10[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+// Longest number the strtod fallback converts from a stack copy; longer ones are copied to the heap
+static const size_t STACK_NUMBER_SIZE = 128;
+
+#if defined(_MSC_VER)
+typedef _locale_t NumberLocale;
+#else
+typedef locale_t NumberLocale;
+#endif //_MSC_VER
+
+/// <summary>
+/// Gets the "C" locale, created once and then shared, so parsing and formatting don't depend on the global locale
+/// </summary>
+/// <returns>Handle of the "C" locale</returns>
+static NumberLocale classicLocale()
+{
+#if defined(_MSC_VER)
+	static const NumberLocale locale = _create_locale(LC_ALL, "C");
+#else
+	static const NumberLocale locale = newlocale(LC_ALL_MASK, "C", static_cast<locale_t>(0));
+#endif //_MSC_VER
+	return locale;
+}
+
+// "00" through "99", used to write two digits at a time
+static const char DIGIT_PAIRS[] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+/// <summary>
+/// Parses a signed base 10 integer from [first, last). An optional leading '+' or '-' is allowed.
+/// </summary>
+/// <param name="first">Pointer to the first char</param>
+/// <param name="last">Pointer one past the last char</param>
+/// <param name="value">On success, gets the parsed value. Left alone on failure</param>
+/// <returns>True if the whole range is an integer that fits in an int64_t</returns>
+bool NumberFunctions::parseInt(const char *first, const char *last, int64_t &value)
+{
+	if (first == last)
+	{
+		return false;
+	}
+
+	bool negative = *first == '-';
+	const char *digits = (*first == '-' || *first == '+') ? first + 1 : first;
+
+	uint64_t magnitude = 0;
+	if (!NumberFunctions::parseUInt(digits, last, magnitude))
+	{
+		return false;
+	}
+
+	uint64_t limit = static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) + (negative ? 1 : 0);
+	if (magnitude > limit)
+	{
+		return false;
+	}
+
+	// Negate in unsigned space so INT64_MIN does not overflow
+	value = negative ? static_cast<int64_t>(0 - magnitude) : static_cast<int64_t>(magnitude);
+	return true;
+}
+
+/// <summary>
+/// Parses a signed base 10 integer from the given std::string
+/// </summary>
+/// <param name="str">The std::string to parse</param>
+/// <param name="value">On success, gets the parsed value. Left alone on failure</param>
+/// <returns>True if the whole std::string is an integer that fits in an int64_t</returns>
+bool NumberFunctions::parseInt(const std::string &str, int64_t &value)
+{
+	return NumberFunctions::parseInt(str.data(), str.data() + str.size(), value);
+}
+
+/// <summary>
+/// Parses an unsigned base 10 integer from [first, last). Runs of 8 digits are converted at once.
+/// </summary>
+/// <param name="first">Pointer to the first char</param>
+/// <param name="last">Pointer one past the last char</param>
+/// <param name="value">On success, gets the parsed value. Left alone on failure</param>
+/// <returns>True if the whole range is digits that fit in a uint64_t</returns>
+bool NumberFunctions::parseUInt(const char *first, const char *last, uint64_t &value)
+{
+	const char *cur = first;
+	uint64_t result = 0;
+
+	if (first == last || !NumberFunctions::parseDigits(cur, last, result) || cur != last)
+	{
+		return false;
+	}
+
+	value = result;
+	return true;
+}
+
+/// <summary>
+/// Parses an unsigned base 10 integer from the given std::string
+/// </summary>
+/// <param name="str">The std::string to parse</param>
+/// <param name="value">On success, gets the parsed value. Left alone on failure</param>
+/// <returns>True if the whole std::string is digits that fit in a uint64_t</returns>
+bool NumberFunctions::parseUInt(const std::string &str, uint64_t &value)
+{
+	return NumberFunctions::parseUInt(str.data(), str.data() + str.size(), value);
+}
+
+/// <summary>
+/// Parses a floating point number from [first, last).
+/// Accepts [+-]digits[.digits][(e|E)[+-]digits] as well as "inf", "infinity" and "nan" in any case.
+/// Numbers with at most 19 significant digits and a small exponent are converted exactly without any library call;
+/// the rest fall back to strtod in the "C" locale.
+/// </summary>
+/// <param name="first">Pointer to the first char</param>
+/// <param name="last">Pointer one past the last char</param>
+/// <param name="value">On success, gets the parsed value. Left alone on failure</param>
+/// <returns>True if the whole range is a number within the range of a double</returns>
+bool NumberFunctions::parseDouble(const char *first, const char *last, double &value)
+{
+	const char *cur = first;
+	if (cur == last)
+	{
+		return false;
+	}
+
+	bool negative = *cur == '-';
+	if (*cur == '-' || *cur == '+')
+	{
+		cur++;
+	}
+
+	// Special values
+	if (cur != last && (*cur == 'i' || *cur == 'I' || *cur == 'n' || *cur == 'N'))
+	{
+		std::string rest(cur, last);
+		for (char &c : rest)
+		{
+			c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+		}
+
+		if (rest == "inf" || rest == "infinity")
+		{
+			value = negative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+			return true;
+		}
+		if (rest == "nan")
+		{
+			value = negative ? -std::numeric_limits<double>::quiet_NaN() : std::numeric_limits<double>::quiet_NaN();
+			return true;
+		}
+		return false;
+	}
+
+	uint64_t mantissa = 0;
+	int64_t exponent = 0;
+	size_t significant_digits = 0;
+	bool any_digits = false;
+	bool truncated = false;
+
+	for (; cur != last && *cur >= '0' && *cur <= '9'; cur++)
+	{
+		unsigned int digit = *cur - '0';
+		any_digits = true;
+
+		if (mantissa == 0 && digit == 0)
+		{
+			continue;
+		}
+
+		if (significant_digits < 19)
+		{
+			mantissa = mantissa * 10 + digit;
+			significant_digits++;
+		}
+		else
+		{
+			exponent++;
+			truncated = truncated || digit != 0;
+		}
+	}
+
+	if (cur != last && *cur == '.')
+	{
+		for (cur++; cur != last && *cur >= '0' && *cur <= '9'; cur++)
+		{
+			unsigned int digit = *cur - '0';
+			any_digits = true;
+
+			if (mantissa == 0 && digit == 0)
+			{
+				exponent--;
+				continue;
+			}
+
+			if (significant_digits < 19)
+			{
+				mantissa = mantissa * 10 + digit;
+				significant_digits++;
+				exponent--;
+			}
+			else
+			{
+				truncated = truncated || digit != 0;
+			}
+		}
+	}
+
+	if (!any_digits)
+	{
+		return false;
+	}
+
+	if (cur != last && (*cur == 'e' || *cur == 'E'))
+	{
+		cur++;
+		bool exponent_negative = cur != last && *cur == '-';
+		if (cur != last && (*cur == '-' || *cur == '+'))
+		{
+			cur++;
+		}
+
+		if (cur == last || *cur < '0' || *cur > '9')
+		{
+			return false;
+		}
+
+		int64_t written_exponent = 0;
+		for (; cur != last && *cur >= '0' && *cur <= '9'; cur++)
+		{
+			// Anything this large is already far outside the range of a double
+			if (written_exponent < 100000)
+			{
+				written_exponent = written_exponent * 10 + (*cur - '0');
+			}
+		}
+		exponent += exponent_negative ? -written_exponent : written_exponent;
+	}
+
+	if (cur != last)
+	{
+		return false;
+	}
+
+	if (mantissa == 0)
+	{
+		value = negative ? -0.0 : 0.0;
+		return true;
+	}
+
+	// Clinger's fast path: both operands are exact, so the one rounding step is correct
+	if (!truncated && mantissa <= (static_cast<uint64_t>(1) << 53) && exponent >= -22 && exponent <= 22)
+	{
+		double result = static_cast<double>(mantissa);
+		result = exponent < 0 ? result / EXACT_POWERS_OF_10[-exponent] : result * EXACT_POWERS_OF_10[exponent];
+		value = negative ? -result : result;
+		return true;
+	}
+
+	// The range is known to be a well formed decimal number by now, strtod just needs it null terminated
+	size_t size = static_cast<size_t>(last - first);
+	char stack_copy[STACK_NUMBER_SIZE];
+	std::unique_ptr<char[]> heap_copy;
+	char *copy = stack_copy;
+	if (size >= STACK_NUMBER_SIZE)
+	{
+		heap_copy.reset(new char[size + 1]);
+		copy = heap_copy.get();
+	}
+	memcpy(copy, first, size);
+	copy[size] = '\0';
+
+	char *end = nullptr;
+#if defined(_MSC_VER)
+	double result = _strtod_l(copy, &end, classicLocale());
+#else
+	double result = strtod_l(copy, &end, classicLocale());
+#endif //_MSC_VER
+
+	// Underflow quietly rounds to a denormal or 0, overflow fails
+	if (end != copy + size || std::isinf(result))
+	{
+		return false;
+	}
+
+	value = result;
+	return true;
+}
+
+/// <summary>
+/// Parses a floating point number from the given std::string
+/// </summary>
+/// <param name="str">The std::string to parse</param>
+/// <param name="value">On success, gets the parsed value. Left alone on failure</param>
+/// <returns>True if the whole std::string is a number within the range of a double</returns>
+bool NumberFunctions::parseDouble(const std::string &str, double &value)
+{
+	return NumberFunctions::parseDouble(str.data(), str.data() + str.size(), value);
+}
+
+/// <summary>
+/// Writes a signed integer in base 10 into a caller supplied buffer. No null terminator is written.
+/// </summary>
+/// <param name="value">The value to write</param>
+/// <param name="buf">The buffer to write to</param>
+/// <param name="buf_size">Size of buf in chars</param>
+/// <returns>Number of chars written, or 0 if buf is too small (buf is then left alone)</returns>
+size_t NumberFunctions::formatInt(const int64_t &value, char *buf, const size_t &buf_size)
+{
+	if (value >= 0)
+	{
+		return NumberFunctions::formatUInt(static_cast<uint64_t>(value), buf, buf_size);
+	}
+
+	if (buf_size < 2)
+	{
+		return 0;
+	}
+
+	size_t written = NumberFunctions::formatUInt(0 - static_cast<uint64_t>(value), buf + 1, buf_size - 1);
+	if (written == 0)
+	{
+		return 0;
+	}
+
+	buf[0] = '-';
+	return written + 1;
+}
+
+/// <summary>
+/// Writes an unsigned integer in base 10 into a caller supplied buffer, two digits at a time. No null terminator is written.
+/// </summary>
+/// <param name="value">The value to write</param>
+/// <param name="buf">The buffer to write to</param>
+/// <param name="buf_size">Size of buf in chars</param>
+/// <returns>Number of chars written, or 0 if buf is too small (buf is then left alone)</returns>
+size_t NumberFunctions::formatUInt(const uint64_t &value, char *buf, const size_t &buf_size)
+{
+	char digits[20];
+	char *pos = digits + sizeof(digits);
+	uint64_t remaining = value;
+
+	while (remaining >= 100)
+	{
+		size_t pair = static_cast<size_t>(remaining % 100) * 2;
+		remaining /= 100;
+		pos -= 2;
+		pos[0] = DIGIT_PAIRS[pair];
+		pos[1] = DIGIT_PAIRS[pair + 1];
+	}
+
+	if (remaining >= 10)
+	{
+		size_t pair = static_cast<size_t>(remaining) * 2;
+		pos -= 2;
+		pos[0] = DIGIT_PAIRS[pair];
+		pos[1] = DIGIT_PAIRS[pair + 1];
+	}
+	else
+	{
+		*--pos = static_cast<char>('0' + remaining);
+	}
+
+	size_t length = static_cast<size_t>(digits + sizeof(digits) - pos);
+	if (length > buf_size)
+	{
+		return 0;
+	}
+
+	memcpy(buf, pos, length);
+	return length;
+}
+
+/// <summary>
+/// Writes a double into a caller supplied buffer using the fewest significant digits (15 to 17) that parse back to the same value.
+/// Always uses '.' as the decimal point. No null terminator is written.
+/// </summary>
+/// <param name="value">The value to write</param>
+/// <param name="buf">The buffer to write to</param>
+/// <param name="buf_size">Size of buf in chars</param>
+/// <returns>Number of chars written, or 0 if buf is too small (buf is then left alone)</returns>
+size_t NumberFunctions::formatDouble(const double &value, char *buf, const size_t &buf_size)
+{
+	char tmp[32];
+	int length = 0;
+
+	if (std::isnan(value))
+	{
+		length = snprintf(tmp, sizeof(tmp), "nan");
+	}
+	else if (std::isinf(value))
+	{
+		length = snprintf(tmp, sizeof(tmp), value < 0 ? "-inf" : "inf");
+	}
+	else
+	{
+#if !defined(_MSC_VER)
+		// Format in the "C" locale on this thread only; POSIX has no snprintf_l
+		NumberLocale previous_locale = uselocale(classicLocale());
+#endif //_MSC_VER
+
+		for (int precision = 15; precision <= 17; precision++)
+		{
+#if defined(_MSC_VER)
+			length = _snprintf_l(tmp, sizeof(tmp), "%.*g", classicLocale(), precision, value);
+#else
+			length = snprintf(tmp, sizeof(tmp), "%.*g", precision, value);
+#endif //_MSC_VER
+
+			double round_trip = 0;
+			if (NumberFunctions::parseDouble(tmp, tmp + length, round_trip) && round_trip == value)
+			{
+				break;
+			}
+		}
+
+#if !defined(_MSC_VER)
+		uselocale(previous_locale);
+#endif //_MSC_VER
+	}
+
+	if (length <= 0 || static_cast<size_t>(length) > buf_size)
+	{
+		return 0;
+	}
+
+	memcpy(buf, tmp, length);
+	return static_cast<size_t>(length);
+}
+
+/// <summary>
+/// Parses every field of a column (such as one produced by StringFunctions::splitIntoVector()) as a signed integer
+/// </summary>
+/// <param name="fields">The fields to parse</param>
+/// <param name="values">Gets one value per field. Fields that fail to parse become 0</param>
+/// <returns>Number of fields that failed to parse</returns>
+size_t NumberFunctions::parseIntColumn(const std::vector<std::string> &fields, std::vector<int64_t> &values)
+{
+	size_t failures = 0;
+	values.resize(fields.size());
+
+	for (size_t i = 0; i < fields.size(); i++)
+	{
+		if (!NumberFunctions::parseInt(fields[i], values[i]))
+		{
+			values[i] = 0;
+			failures++;
+		}
+	}
+
+	return failures;
+}
+
+/// <summary>
+/// Parses every field of a column (such as one produced by StringFunctions::splitIntoVector()) as a double
+/// </summary>
+/// <param name="fields">The fields to parse</param>
+/// <param name="values">Gets one value per field. Fields that fail to parse become NaN</param>
+/// <returns>Number of fields that failed to parse</returns>
+size_t NumberFunctions::parseDoubleColumn(const std::vector<std::string> &fields, std::vector<double> &values)
+{
+	size_t failures = 0;
+	values.resize(fields.size());
+
+	for (size_t i = 0; i < fields.size(); i++)
+	{
+		if (!NumberFunctions::parseDouble(fields[i], values[i]))
+		{
+			values[i] = std::numeric_limits<double>::quiet_NaN();
+			failures++;
+		}
+	}
+
+	return failures;
+}
+
+/// <summary>
+/// Determines if all 8 bytes of a little endian word are ASCII digits
+/// </summary>
+/// <param name="word">8 chars packed into a uint64_t</param>
+/// <returns>True if every char is '0' to '9'</returns>
+bool NumberFunctions::isEightDigits(const uint64_t &word)
+{
+	// High nibble must be 3, and adding 6 must not carry a digit past '9' into the high nibble
+	return ((word & 0xF0F0F0F0F0F0F0F0ULL) | (((word + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) == 0x3333333333333333ULL;
+}
+
+/// <summary>
+/// Converts 8 ASCII digits packed into a little endian word into their value, using 3 multiplies instead of 8
+/// </summary>
+/// <param name="word">8 digit chars packed into a uint64_t (first char in the lowest byte)</param>
+/// <returns>The 8 digit value</returns>
+uint64_t NumberFunctions::parseEightDigits(const uint64_t &word)
+{
+	const uint64_t MASK = 0x000000FF000000FFULL;
+	const uint64_t MUL1 = 100 + (1000000ULL << 32);
+	const uint64_t MUL2 = 1 + (10000ULL << 32);
+
+	uint64_t val = word - 0x3030303030303030ULL;
+	val = (val * 10) + (val >> 8);
+	val = (((val & MASK) * MUL1) + (((val >> 16) & MASK) * MUL2)) >> 32;
+	return val;
+}
+
+/// <summary>
+/// Consumes base 10 digits starting at cur, 8 at a time where possible
+/// </summary>
+/// <param name="cur">Pointer to the first char. Left pointing at the first non-digit</param>
+/// <param name="last">Pointer one past the last char</param>
+/// <param name="value">Gets the value of the digits</param>
+/// <returns>False if the digits overflow a uint64_t</returns>
+bool NumberFunctions::parseDigits(const char *&cur, const char *last, uint64_t &value)
+{
+	const uint64_t MAX = std::numeric_limits<uint64_t>::max();
+	uint64_t result = 0;
+
+	if (NUMBER_LITTLE_ENDIAN)
+	{
+		while (last - cur >= 8)
+		{
+			uint64_t word;
+			memcpy(&word, cur, sizeof(word));
+			if (!NumberFunctions::isEightDigits(word))
+			{
+				break;
+			}
+
+			uint64_t chunk = NumberFunctions::parseEightDigits(word);
+			if (result > (MAX - chunk) / 100000000ULL)
+			{
+				return false;
+			}
+			result = result * 100000000ULL + chunk;
+			cur += 8;
+		}
+	}
+
+	for (; cur != last && *cur >= '0' && *cur <= '9'; cur++)
+	{
+		uint64_t digit = static_cast<uint64_t>(*cur - '0');
+		if (result > (MAX - digit) / 10)
+		{
+			return false;
+		}
+		result = result * 10 + digit;
+	}
+
+	value = result;
+	return true;
+}
+
+#endif NumberFunctions_CPP
@@ -0,0 +1,41 @@
+/*
+* This is the header file for the NumberFunctions class of cPlusPlusPlusLib
+* cPPPLib - A library of functions that should be in the C++ Standard Library
+* (C) - Charles Machalow - MIT License
+*/
+
+#ifndef NumberFunctions_H
+#define NumberFunctions_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Class for locale independent, non-throwing parsing and formatting of numbers.
+/// Parsers accept the whole range or nothing: no surrounding whitespace and no trailing characters.
+/// </summary>
+class NumberFunctions
+{
+public:
+	static bool parseInt(const char *first, const char *last, int64_t &value);
+	static bool parseInt(const std::string &str, int64_t &value);
+	static bool parseUInt(const char *first, const char *last, uint64_t &value);
+	static bool parseUInt(const std::string &str, uint64_t &value);
+	static bool parseDouble(const char *first, const char *last, double &value);
+	static bool parseDouble(const std::string &str, double &value);
+
+	static size_t formatInt(const int64_t &value, char *buf, const size_t &buf_size);
+	static size_t formatUInt(const uint64_t &value, char *buf, const size_t &buf_size);
+	static size_t formatDouble(const double &value, char *buf, const size_t &buf_size);
+
+	static size_t parseIntColumn(const std::vector<std::string> &fields, std::vector<int64_t> &values);
+	static size_t parseDoubleColumn(const std::vector<std::string> &fields, std::vector<double> &values);
+
+private:
+	static bool isEightDigits(const uint64_t &word);
+	static uint64_t parseEightDigits(const uint64_t &word);
+	static bool parseDigits(const char *&cur, const char *last, uint64_t &value);
+};
+
+#endif NumberFunctions_H
@@ -0,0 +1,98 @@
+/*
+* This is the header file for the PipelineStage class of cPlusPlusPlusLib
+* cPPPLib - A library of functions that should be in the C++ Standard Library
+* (C) - Charles Machalow - MIT License
+*/
+
+#ifndef PipelineStage_H
+#define PipelineStage_H
+
+#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "RingBuffer.h"
+
+/// <summary>
+/// One stage of a multi-threaded pipeline: a thread that pops items from an input SpscRingBuffer,
+/// transforms them and pushes the results to an output SpscRingBuffer, a batch at a time.
+/// When the input is closed and drained, the stage closes its output, so closing the first queue shuts down the whole chain.
+/// Example stage that trims std::strings in place of their copies:
+///     PipelineStage<std::string, std::string> trim_stage(split_out, trim_out, [](std::string &&str) { return StringFunctions::trim(std::move(str)); });
+/// </summary>
+template <typename In, typename Out> class PipelineStage
+{
+public:
+	/// <summary>
+	/// Constructor for a PipelineStage. Starts its thread.
+	/// </summary>
+	/// <param name="input">Queue to pop items from. This stage must be its only consumer</param>
+	/// <param name="output">Queue to push results to. This stage must be its only producer</param>
+	/// <param name="transform">Function turning an In (moved in) into an Out</param>
+	/// <param name="batch_size">Max items moved per queue operation (Defaults to 64)</param>
+	PipelineStage(SpscRingBuffer<In> &input, SpscRingBuffer<Out> &output, std::function<Out(In &&)> transform, const size_t &batch_size = 64)
+		: input(input), output(output), transform(std::move(transform)), batch_size(std::max(batch_size, static_cast<size_t>(1)))
+	{
+		worker = std::thread(&PipelineStage::run, this);
+	}
+
+	/// <summary>
+	/// Destructor for a PipelineStage. Waits for the stage to drain its input, so close the input first.
+	/// </summary>
+	~PipelineStage()
+	{
+		join();
+	}
+
+	PipelineStage(const PipelineStage &) = delete;
+	PipelineStage &operator=(const PipelineStage &) = delete;
+
+	/// <summary>
+	/// Waits until the input is closed and every item has been pushed to the output
+	/// </summary>
+	void join()
+	{
+		if (worker.joinable())
+		{
+			worker.join();
+		}
+	}
+
+private:
+	/// <summary>
+	/// The stage's thread: pop a batch, transform it, push the batch, until the input is closed and empty
+	/// </summary>
+	void run()
+	{
+		std::vector<In> in_batch(batch_size);
+		std::vector<Out> out_batch;
+		out_batch.reserve(batch_size);
+
+		while (true)
+		{
+			size_t popped = input.popBatch(in_batch.data(), batch_size);
+			if (popped == 0)
+			{
+				break;
+			}
+
+			out_batch.clear();
+			for (size_t i = 0; i < popped; i++)
+			{
+				out_batch.push_back(transform(std::move(in_batch[i])));
+			}
+			output.pushBatch(out_batch.data(), out_batch.size());
+		}
+
+		output.close();
+	}
+
+	SpscRingBuffer<In> &input;
+	SpscRingBuffer<Out> &output;
+	std::function<Out(In &&)> transform;
+	const size_t batch_size;
+	std::thread worker;
+};
+
+#endif PipelineStage_H
@@ -0,0 +1,814 @@
+/*
+* This is the cpp file for the Profiler class of cPlusPlusPlusLib
+* cPPPLib - A library of functions that should be in the C++ Standard Library
+* (C) - Charles Machalow - MIT License
+*/
+
+#ifndef Profiler_CPP
+#define Profiler_CPP
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define PROFILER_USE_TSC
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif //_MSC_VER
+#endif //x86
+
+#ifdef __linux
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif //__linux
+
+/// <summary>
+/// Determines if the CPU has an invariant TSC: one that ticks at a constant rate across frequency changes and sleep states.
+/// Without one (or when a hypervisor hides it) the TSC can't be used as a clock.
+/// </summary>
+/// <returns>True if rdtsc can be used as a clock</returns>
+static bool hasInvariantTsc()
+{
+#ifdef PROFILER_USE_TSC
+#ifdef _MSC_VER
+	int regs[4];
+	__cpuid(regs, 0x80000000);
+	if (static_cast<unsigned int>(regs[0]) < 0x80000007)
+	{
+		return false;
+	}
+	__cpuid(regs, 0x80000007);
+	return (regs[3] & (1 << 8)) != 0;
+#else
+	unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+	if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx))
+	{
+		return false;
+	}
+	return (edx & (1u << 8)) != 0;
+#endif //_MSC_VER
+#else
+	return false;
+#endif //PROFILER_USE_TSC
+}
+
+static const bool PROFILER_INVARIANT_TSC = hasInvariantTsc();
+
+std::atomic<bool> Profiler::counters_enabled(false);
+
+/// <summary>
+/// Constructor for a SiteStats with every count at zero
+/// </summary>
+Profiler::SiteStats::SiteStats()
+{
+	for (size_t i = 0; i < BUCKET_COUNT; i++)
+	{
+		buckets[i].store(0, std::memory_order_relaxed);
+	}
+	for (size_t i = 0; i < HardwareCounterCount; i++)
+	{
+		counter_totals[i].store(0, std::memory_order_relaxed);
+	}
+	count.store(0, std::memory_order_relaxed);
+	total_ticks.store(0, std::memory_order_relaxed);
+	max_ticks.store(0, std::memory_order_relaxed);
+}
+
+/// <summary>
+/// Constructor for a ThreadStatsHolder that holds nothing yet
+/// </summary>
+Profiler::ThreadStatsHolder::ThreadStatsHolder() : stats(nullptr)
+{
+}
+
+/// <summary>
+/// Destructor for a ThreadStatsHolder. Runs as its thread exits, and retires the thread's timings.
+/// </summary>
+Profiler::ThreadStatsHolder::~ThreadStatsHolder()
+{
+	if (stats != nullptr)
+	{
+		Profiler::retireThread(stats);
+		stats = nullptr;
+	}
+}
+
+/// <summary>
+/// Constructor for an empty MergedStats
+/// </summary>
+Profiler::MergedStats::MergedStats() : buckets(BUCKET_COUNT, 0), count(0), total_ticks(0), max_ticks(0)
+{
+	for (size_t i = 0; i < HardwareCounterCount; i++)
+	{
+		counter_totals[i] = 0;
+	}
+}
+
+/// <summary>
+/// Reads the profiler clock.
+/// Uses rdtsc when the CPU has an invariant TSC, otherwise clock_gettime(CLOCK_MONOTONIC) (Linux) or std::chrono::steady_clock.
+/// </summary>
+/// <returns>Current tick count. Only differences between tick counts are meaningful</returns>
+uint64_t Profiler::ticks()
+{
+#ifdef PROFILER_USE_TSC
+	if (PROFILER_INVARIANT_TSC)
+	{
+		return __rdtsc();
+	}
+#endif //PROFILER_USE_TSC
+#ifdef __linux
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<uint64_t>(now.tv_nsec);
+#else
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif //__linux
+}
+
+/// <summary>
+/// Gets the rate of the profiler clock.
+/// For the TSC, this is calibrated against std::chrono::steady_clock over 20ms on first call.
+/// </summary>
+/// <returns>Ticks per nanosecond</returns>
+double Profiler::ticksPerNanosecond()
+{
+	static const double ratio = []()
+	{
+		if (!PROFILER_INVARIANT_TSC)
+		{
+			return 1.0;
+		}
+
+		std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+		uint64_t start_ticks = Profiler::ticks();
+		std::chrono::steady_clock::time_point end_time = start_time;
+		while (end_time - start_time < std::chrono::milliseconds(20))
+		{
+			end_time = std::chrono::steady_clock::now();
+		}
+		uint64_t end_ticks = Profiler::ticks();
+
+		double nanoseconds = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count());
+		return static_cast<double>(end_ticks - start_ticks) / nanoseconds;
+	}();
+
+	return ratio;
+}
+
+/// <summary>
+/// Converts a number of profiler clock ticks to nanoseconds
+/// </summary>
+/// <param name="tick_count">Number of ticks</param>
+/// <returns>Number of nanoseconds</returns>
+uint64_t Profiler::ticksToNanoseconds(const uint64_t &tick_count)
+{
+	return static_cast<uint64_t>(static_cast<double>(tick_count) / Profiler::ticksPerNanosecond() + 0.5);
+}
+
+/// <summary>
+/// Gets the id of a named site, registering it if this is the first use of the name.
+/// Takes a lock, so look the id up once (e.g. into a static) rather than on every timing.
+/// </summary>
+/// <param name="name">Name of the site, as shown in reports</param>
+/// <returns>Id of the site, for record() and ScopedTimer</returns>
+size_t Profiler::site(const std::string &name)
+{
+	Registry &reg = Profiler::registry();
+	std::lock_guard<std::mutex> lock(reg.lock);
+
+	std::unordered_map<std::string, size_t>::const_iterator found = reg.site_ids.find(name);
+	if (found != reg.site_ids.end())
+	{
+		return found->second;
+	}
+
+	size_t site_id = reg.site_names.size();
+	reg.site_names.push_back(name);
+	reg.site_ids[name] = site_id;
+	return site_id;
+}
+
+/// <summary>
+/// Records a timing to a site. Lock-free, except for the first timing of a site on each thread.
+/// </summary>
+/// <param name="site_id">Id of the site from site()</param>
+/// <param name="tick_count">The timing, in profiler clock ticks</param>
+void Profiler::record(const size_t &site_id, const uint64_t &tick_count)
+{
+	SiteStats &stats = Profiler::siteStats(site_id);
+
+	Profiler::bump(stats.buckets[Profiler::bucketIndex(tick_count)], 1);
+	Profiler::bump(stats.count, 1);
+	Profiler::bump(stats.total_ticks, tick_count);
+	if (tick_count > stats.max_ticks.load(std::memory_order_relaxed))
+	{
+		stats.max_ticks.store(tick_count, std::memory_order_relaxed);
+	}
+}
+
+/// <summary>
+/// Turns reading of hardware counters by ScopedTimer on or off.
+/// Linux: Uses perf_event_open() for user space cycles, instructions and cache misses.
+///  Needs a kernel.perf_event_paranoid setting that allows self-profiling.
+/// Windows: Not supported
+/// </summary>
+/// <param name="enable">True to turn counters on, False to turn them off (Defaults to True)</param>
+/// <returns>True if counters are now in the requested state, False if they could not be turned on</returns>
+bool Profiler::enableHardwareCounters(const bool &enable)
+{
+	if (enable)
+	{
+		uint64_t values[HardwareCounterCount];
+		if (!Profiler::readHardwareCounters(values))
+		{
+			return false;
+		}
+	}
+
+	counters_enabled.store(enable, std::memory_order_relaxed);
+	return true;
+}
+
+/// <summary>
+/// Determines if ScopedTimer reads hardware counters
+/// </summary>
+/// <returns>True if hardware counters are on</returns>
+bool Profiler::hardwareCountersEnabled()
+{
+	return counters_enabled.load(std::memory_order_relaxed);
+}
+
+/// <summary>
+/// Gets the number of timings recorded to a site across all threads
+/// </summary>
+/// <param name="site_id">Id of the site from site()</param>
+/// <returns>Number of timings</returns>
+uint64_t Profiler::count(const size_t &site_id)
+{
+	return Profiler::merge(site_id).count;
+}
+
+/// <summary>
+/// Gets a percentile of the timings recorded to a site across all threads
+/// </summary>
+/// <param name="site_id">Id of the site from site()</param>
+/// <param name="percentile">The percentile, from 0 to 100 (e.g. 99.9)</param>
+/// <returns>The timing in nanoseconds that percentile of timings are at or below (0 if there are none)</returns>
+uint64_t Profiler::percentileNanoseconds(const size_t &site_id, const double &percentile)
+{
+	return Profiler::ticksToNanoseconds(Profiler::percentileTicks(Profiler::merge(site_id), percentile));
+}
+
+/// <summary>
+/// Builds a text table of every site with timings: count, mean, p50, p99, p999 and max in nanoseconds,
+/// plus the mean of each hardware counter if any were read
+/// </summary>
+/// <returns>std::string of the table, one line per site</returns>
+std::string Profiler::report()
+{
+	std::vector<std::string> names;
+	{
+		Registry &reg = Profiler::registry();
+		std::lock_guard<std::mutex> lock(reg.lock);
+		names = reg.site_names;
+	}
+
+	char line[512];
+	snprintf(line, sizeof(line), "%-32s %12s %12s %12s %12s %12s %12s %14s %14s %14s\n",
+		"site", "count", "mean_ns", "p50_ns", "p99_ns", "p999_ns", "max_ns", "cycles", "instructions", "cache_misses");
+	std::string ret_str = line;
+
+	for (size_t site_id = 0; site_id < names.size(); site_id++)
+	{
+		MergedStats stats = Profiler::merge(site_id);
+		if (stats.count == 0)
+		{
+			continue;
+		}
+
+		snprintf(line, sizeof(line), "%-32s %12llu %12llu %12llu %12llu %12llu %12llu %14llu %14llu %14llu\n",
+			names[site_id].c_str(),
+			static_cast<unsigned long long>(stats.count),
+			static_cast<unsigned long long>(Profiler::ticksToNanoseconds(stats.total_ticks / stats.count)),
+			static_cast<unsigned long long>(Profiler::ticksToNanoseconds(Profiler::percentileTicks(stats, 50))),
+			static_cast<unsigned long long>(Profiler::ticksToNanoseconds(Profiler::percentileTicks(stats, 99))),
+			static_cast<unsigned long long>(Profiler::ticksToNanoseconds(Profiler::percentileTicks(stats, 99.9))),
+			static_cast<unsigned long long>(Profiler::ticksToNanoseconds(stats.max_ticks)),
+			static_cast<unsigned long long>(stats.counter_totals[Cycles] / stats.count),
+			static_cast<unsigned long long>(stats.counter_totals[Instructions] / stats.count),
+			static_cast<unsigned long long>(stats.counter_totals[CacheMisses] / stats.count));
+		ret_str += line;
+	}
+
+	return ret_str;
+}
+
+/// <summary>
+/// Builds a JSON document of every site with timings. Fields match the columns of report().
+/// </summary>
+/// <returns>std::string of the JSON: {"sites": [{"name": ..., "count": ..., ...}, ...]}</returns>
+std::string Profiler::reportJson()
+{
+	std::vector<std::string> names;
+	{
+		Registry &reg = Profiler::registry();
+		std::lock_guard<std::mutex> lock(reg.lock);
+		names = reg.site_names;
+	}
+
+	std::string ret_str = "{\"sites\": [";
+	bool first = true;
+
+	for (size_t site_id = 0; site_id < names.size(); site_id++)
+	{
+		MergedStats stats = Profiler::merge(site_id);
+		if (stats.count == 0)
+		{
+			continue;
+		}
+
+		if (!first)
+		{
+			ret_str += ", ";
+		}
+		first = false;
+
+		ret_str += "{\"name\": \"";
+		for (size_t i = 0; i < names[site_id].size(); i++)
+		{
+			unsigned char c = static_cast<unsigned char>(names[site_id][i]);
+			if (c == '"' || c == '\\')
+			{
+				ret_str += '\\';
+				ret_str += static_cast<char>(c);
+			}
+			else if (c < 0x20)
+			{
+				char escaped[8];
+				snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+				ret_str += escaped;
+			}
+			else
+			{
+				ret_str += static_cast<char>(c);
+			}
+		}
+
+		char fields[512];
+		snprintf(fields, sizeof(fields),
+			"\", \"count\": %llu, \"mean_ns\": %llu, \"p50_ns\": %llu, \"p99_ns\": %llu, \"p999_ns\": %llu, \"max_ns\": %llu, "
+			"\"cycles\": %llu, \"instructions\": %llu, \"cache_misses\": %llu}",
+			static_cast<unsigned long long>(stats.count),
+			static_cast<unsigned long long>(Profiler::ticksToNanoseconds(stats.total_ticks / stats.count)),
+			static_cast<unsigned long long>(Profiler::ticksToNanoseconds(Profiler::percentileTicks(stats, 50))),
+			static_cast<unsigned long long>(Profiler::ticksToNanoseconds(Profiler::percentileTicks(stats, 99))),
+			static_cast<unsigned long long>(Profiler::ticksToNanoseconds(Profiler::percentileTicks(stats, 99.9))),
+			static_cast<unsigned long long>(Profiler::ticksToNanoseconds(stats.max_ticks)),
+			static_cast<unsigned long long>(stats.counter_totals[Cycles] / stats.count),
+			static_cast<unsigned long long>(stats.counter_totals[Instructions] / stats.count),
+			static_cast<unsigned long long>(stats.counter_totals[CacheMisses] / stats.count));
+		ret_str += fields;
+	}
+
+	ret_str += "]}";
+	return ret_str;
+}
+
+/// <summary>
+/// Clears every site's timings. Sites stay registered.
+/// A timing recorded while this runs may survive the reset.
+/// </summary>
+void Profiler::reset()
+{
+	Registry &reg = Profiler::registry();
+	std::lock_guard<std::mutex> lock(reg.lock);
+
+	reg.retired.clear();
+
+	for (size_t t = 0; t < reg.thread_stats.size(); t++)
+	{
+		for (size_t s = 0; s < reg.thread_stats[t]->sites.size(); s++)
+		{
+			SiteStats *stats = reg.thread_stats[t]->sites[s].get();
+			if (stats == nullptr)
+			{
+				continue;
+			}
+
+			for (size_t i = 0; i < BUCKET_COUNT; i++)
+			{
+				stats->buckets[i].store(0, std::memory_order_relaxed);
+			}
+			for (size_t i = 0; i < HardwareCounterCount; i++)
+			{
+				stats->counter_totals[i].store(0, std::memory_order_relaxed);
+			}
+			stats->count.store(0, std::memory_order_relaxed);
+			stats->total_ticks.store(0, std::memory_order_relaxed);
+			stats->max_ticks.store(0, std::memory_order_relaxed);
+		}
+	}
+}
+
+/// <summary>
+/// Gets the registry. It is never destroyed, so threads can still record while statics are torn down at exit.
+/// </summary>
+/// <returns>The Registry</returns>
+Profiler::Registry &Profiler::registry()
+{
+	static Registry *reg = new Registry();
+	return *reg;
+}
+
+/// <summary>
+/// Gets the calling thread's timings for a site, creating them on first use
+/// </summary>
+/// <param name="site_id">Id of the site</param>
+/// <returns>The calling thread's SiteStats for the site</returns>
+Profiler::SiteStats &Profiler::siteStats(const size_t &site_id)
+{
+	static thread_local ThreadStatsHolder holder;
+	ThreadStats *&current = holder.stats;
+
+	if (current != nullptr && site_id < current->sites.size() && current->sites[site_id])
+	{
+		return *current->sites[site_id];
+	}
+
+	Registry &reg = Profiler::registry();
+	std::lock_guard<std::mutex> lock(reg.lock);
+
+	if (current == nullptr)
+	{
+		reg.thread_stats.emplace_back(new ThreadStats());
+		current = reg.thread_stats.back().get();
+	}
+
+	if (site_id >= current->sites.size())
+	{
+		current->sites.resize(site_id + 1);
+	}
+
+	if (!current->sites[site_id])
+	{
+		current->sites[site_id].reset(new SiteStats());
+	}
+
+	return *current->sites[site_id];
+}
+
+/// <summary>
+/// Adds hardware counter readings of one scope to a site
+/// </summary>
+/// <param name="site_id">Id of the site</param>
+/// <param name="deltas">HardwareCounterCount counter values</param>
+void Profiler::addHardwareCounters(const size_t &site_id, const uint64_t *deltas)
+{
+	SiteStats &stats = Profiler::siteStats(site_id);
+
+	for (size_t i = 0; i < HardwareCounterCount; i++)
+	{
+		Profiler::bump(stats.counter_totals[i], deltas[i]);
+	}
+}
+
+/// <summary>
+/// Reads the calling thread's hardware counters, opening them on first use
+/// </summary>
+/// <param name="values">Array of HardwareCounterCount uint64_ts. Gets the counter values</param>
+/// <returns>True on success, False if counters are not available on this thread</returns>
+bool Profiler::readHardwareCounters(uint64_t *values)
+{
+#ifdef __linux
+	// The calling thread's perf_event group: cycles leads, the others follow it
+	struct CounterGroup
+	{
+		int fds[HardwareCounterCount];
+		bool tried;
+		bool opened;
+
+		CounterGroup() : tried(false), opened(false)
+		{
+			for (size_t i = 0; i < HardwareCounterCount; i++)
+			{
+				fds[i] = -1;
+			}
+		}
+
+		~CounterGroup()
+		{
+			for (size_t i = 0; i < HardwareCounterCount; i++)
+			{
+				if (fds[i] >= 0)
+				{
+					close(fds[i]);
+				}
+			}
+		}
+	};
+
+	static thread_local CounterGroup group;
+
+	if (!group.tried)
+	{
+		group.tried = true;
+
+		const uint64_t configs[HardwareCounterCount] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES };
+		for (size_t i = 0; i < HardwareCounterCount; i++)
+		{
+			perf_event_attr attr;
+			memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.config = configs[i];
+			attr.read_format = PERF_FORMAT_GROUP;
+			attr.disabled = i == 0 ? 1 : 0;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+
+			group.fds[i] = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, i == 0 ? -1 : group.fds[0], 0));
+			if (group.fds[i] < 0)
+			{
+				return false;
+			}
+		}
+
+		if (ioctl(group.fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP) != 0)
+		{
+			return false;
+		}
+		group.opened = true;
+	}
+
+	if (!group.opened)
+	{
+		return false;
+	}
+
+	uint64_t buf[1 + HardwareCounterCount];
+	if (read(group.fds[0], buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf)))
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < HardwareCounterCount; i++)
+	{
+		values[i] = buf[1 + i];
+	}
+	return true;
+#else
+	(void)values;
+	return false;
+#endif //__linux
+}
+
+/// <summary>
+/// Merges a site's timings from every thread
+/// </summary>
+/// <param name="site_id">Id of the site</param>
+/// <returns>MergedStats of the site</returns>
+Profiler::MergedStats Profiler::merge(const size_t &site_id)
+{
+	Registry &reg = Profiler::registry();
+	std::lock_guard<std::mutex> lock(reg.lock);
+
+	MergedStats merged;
+	if (site_id < reg.retired.size() && reg.retired[site_id])
+	{
+		merged = *reg.retired[site_id];
+	}
+
+	for (size_t t = 0; t < reg.thread_stats.size(); t++)
+	{
+		const ThreadStats &thread = *reg.thread_stats[t];
+		if (site_id < thread.sites.size() && thread.sites[site_id])
+		{
+			Profiler::foldInto(*thread.sites[site_id], merged);
+		}
+	}
+
+	return merged;
+}
+
+/// <summary>
+/// Adds one thread's timings of a site to merged timings
+/// </summary>
+/// <param name="stats">The thread's timings</param>
+/// <param name="merged">The merged timings to add to</param>
+void Profiler::foldInto(const SiteStats &stats, MergedStats &merged)
+{
+	for (size_t i = 0; i < BUCKET_COUNT; i++)
+	{
+		merged.buckets[i] += stats.buckets[i].load(std::memory_order_relaxed);
+	}
+	for (size_t i = 0; i < HardwareCounterCount; i++)
+	{
+		merged.counter_totals[i] += stats.counter_totals[i].load(std::memory_order_relaxed);
+	}
+	merged.count += stats.count.load(std::memory_order_relaxed);
+	merged.total_ticks += stats.total_ticks.load(std::memory_order_relaxed);
+	merged.max_ticks = std::max(merged.max_ticks, stats.max_ticks.load(std::memory_order_relaxed));
+}
+
+/// <summary>
+/// Folds an exiting thread's timings into the registry's retired totals, then frees them
+/// </summary>
+/// <param name="thread">The exiting thread's ThreadStats</param>
+void Profiler::retireThread(ThreadStats *thread)
+{
+	Registry &reg = Profiler::registry();
+	std::lock_guard<std::mutex> lock(reg.lock);
+
+	for (size_t s = 0; s < thread->sites.size(); s++)
+	{
+		if (!thread->sites[s])
+		{
+			continue;
+		}
+
+		if (s >= reg.retired.size())
+		{
+			reg.retired.resize(s + 1);
+		}
+		if (!reg.retired[s])
+		{
+			reg.retired[s].reset(new MergedStats());
+		}
+		Profiler::foldInto(*thread->sites[s], *reg.retired[s]);
+	}
+
+	for (size_t t = 0; t < reg.thread_stats.size(); t++)
+	{
+		if (reg.thread_stats[t].get() == thread)
+		{
+			reg.thread_stats[t].swap(reg.thread_stats.back());
+			reg.thread_stats.pop_back();
+			break;
+		}
+	}
+}
+
+/// <summary>
+/// Finds a percentile in merged timings
+/// </summary>
+/// <param name="stats">The merged timings</param>
+/// <param name="percentile">The percentile, from 0 to 100</param>
+/// <returns>Highest tick count of the bucket holding the percentile, capped at the max timing (0 if there are no timings)</returns>
+uint64_t Profiler::percentileTicks(const MergedStats &stats, const double &percentile)
+{
+	// Use the bucket counts rather than stats.count, which a racing record() may have already bumped
+	uint64_t total = 0;
+	for (size_t i = 0; i < BUCKET_COUNT; i++)
+	{
+		total += stats.buckets[i];
+	}
+
+	if (total == 0)
+	{
+		return 0;
+	}
+
+	double clamped = std::min(std::max(percentile, 0.0), 100.0);
+	uint64_t target = static_cast<uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(total)));
+	target = std::min(std::max(target, static_cast<uint64_t>(1)), total);
+
+	uint64_t seen = 0;
+	for (size_t i = 0; i < BUCKET_COUNT; i++)
+	{
+		seen += stats.buckets[i];
+		if (seen >= target)
+		{
+			return std::min(Profiler::bucketHighestValue(i), stats.max_ticks);
+		}
+	}
+
+	return stats.max_ticks;
+}
+
+/// <summary>
+/// Gets the histogram bucket of a timing.
+/// Values below 64 get their own bucket. Above that, the bucket is picked by the highest set bit and the 5 bits below it.
+/// </summary>
+/// <param name="tick_count">The timing</param>
+/// <returns>Index of the bucket, less than BUCKET_COUNT</returns>
+size_t Profiler::bucketIndex(const uint64_t &tick_count)
+{
+	if (tick_count < 64)
+	{
+		return static_cast<size_t>(tick_count);
+	}
+
+#if defined(__GNUC__) || defined(__clang__)
+	size_t highest_bit = 63 - static_cast<size_t>(__builtin_clzll(tick_count));
+#elif defined(_MSC_VER) && defined(_M_X64)
+	unsigned long index = 0;
+	_BitScanReverse64(&index, tick_count);
+	size_t highest_bit = static_cast<size_t>(index);
+#else
+	size_t highest_bit = 63;
+	while (((tick_count >> highest_bit) & 1) == 0)
+	{
+		highest_bit--;
+	}
+#endif //__GNUC__ || __clang__
+
+	size_t shift = highest_bit - 5;
+	return (shift + 1) * 32 + static_cast<size_t>((tick_count >> shift) - 32);
+}
+
+/// <summary>
+/// Gets the highest timing that falls in a bucket
+/// </summary>
+/// <param name="index">Index of the bucket</param>
+/// <returns>The highest tick count the bucket holds</returns>
+uint64_t Profiler::bucketHighestValue(const size_t &index)
+{
+	if (index < 64)
+	{
+		return index;
+	}
+
+	size_t shift = index / 32 - 1;
+	uint64_t top = index % 32 + 32;
+	return ((top + 1) << shift) - 1;
+}
+
+/// <summary>
+/// Adds to a value that only the calling thread writes. A plain load and store, with no locked instruction.
+/// </summary>
+/// <param name="value">The value to add to</param>
+/// <param name="amount">The amount to add</param>
+void Profiler::bump(std::atomic<uint64_t> &value, const uint64_t &amount)
+{
+	value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+/// <summary>
+/// Constructor for a ScopedTimer that records to a site by id
+/// </summary>
+/// <param name="site_id">Id of the site from Profiler::site()</param>
+ScopedTimer::ScopedTimer(const size_t &site_id) : site_id(site_id)
+{
+	start();
+}
+
+/// <summary>
+/// Constructor for a ScopedTimer that records to a site by name.
+/// Looks the name up each time, so prefer the id constructor in hot code.
+/// </summary>
+/// <param name="name">Name of the site</param>
+ScopedTimer::ScopedTimer(const std::string &name) : site_id(Profiler::site(name))
+{
+	start();
+}
+
+/// <summary>
+/// Destructor for a ScopedTimer. Records the time since construction (and the hardware counters if they were read).
+/// </summary>
+ScopedTimer::~ScopedTimer()
+{
+	uint64_t end_ticks = Profiler::ticks();
+	Profiler::record(site_id, end_ticks - start_ticks);
+
+	uint64_t end_counters[Profiler::HardwareCounterCount];
+	if (counting && Profiler::readHardwareCounters(end_counters))
+	{
+		for (size_t i = 0; i < Profiler::HardwareCounterCount; i++)
+		{
+			end_counters[i] -= start_counters[i];
+		}
+		Profiler::addHardwareCounters(site_id, end_counters);
+	}
+}
+
+/// <summary>
+/// Gets the time since the ScopedTimer was constructed
+/// </summary>
+/// <returns>Elapsed nanoseconds</returns>
+uint64_t ScopedTimer::elapsedNanoseconds() const
+{
+	return Profiler::ticksToNanoseconds(Profiler::ticks() - start_ticks);
+}
+
+/// <summary>
+/// Reads the hardware counters (if on) and then the clock, so the counter read is not part of the timing
+/// </summary>
+void ScopedTimer::start()
+{
+	counting = Profiler::hardwareCountersEnabled() && Profiler::readHardwareCounters(start_counters);
+	start_ticks = Profiler::ticks();
+}
+
+#endif Profiler_CPP
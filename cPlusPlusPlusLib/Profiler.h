@@ -0,0 +1,161 @@
+/*
+* This is the header file for the Profiler class of cPlusPlusPlusLib
+* cPPPLib - A library of functions that should be in the C++ Standard Library
+* (C) - Charles Machalow - MIT License
+*/
+
+#ifndef Profiler_H
+#define Profiler_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// Low overhead latency profiler.
+/// Timings are recorded per named site into a histogram owned by the recording thread, so recording takes no locks.
+/// Histograms are log-linear (HDR style): every value is kept to within about 3% of its true size, from 1 tick up.
+/// Reports merge every thread's histograms. When a thread exits, its histograms are folded into per-site totals and freed.
+/// </summary>
+class Profiler
+{
+public:
+	/// <summary>
+	/// Hardware counters that can be read around a scope (Linux only)
+	/// </summary>
+	enum HardwareCounter
+	{
+		Cycles = 0,
+		Instructions = 1,
+		CacheMisses = 2,
+		HardwareCounterCount = 3
+	};
+
+	static uint64_t ticks();
+	static double ticksPerNanosecond();
+	static uint64_t ticksToNanoseconds(const uint64_t &tick_count);
+
+	static size_t site(const std::string &name);
+	static void record(const size_t &site_id, const uint64_t &tick_count);
+
+	static bool enableHardwareCounters(const bool &enable = true);
+	static bool hardwareCountersEnabled();
+
+	static uint64_t count(const size_t &site_id);
+	static uint64_t percentileNanoseconds(const size_t &site_id, const double &percentile);
+	static std::string report();
+	static std::string reportJson();
+	static void reset();
+
+private:
+	friend class ScopedTimer;
+
+	// Values below 64 get a bucket each, then every power of two is split into 32 buckets
+	static const size_t BUCKET_COUNT = 1920;
+
+	/// <summary>
+	/// One site's timings from one thread. Only the owning thread writes, anyone may read.
+	/// </summary>
+	struct SiteStats
+	{
+		SiteStats();
+
+		std::atomic<uint64_t> buckets[BUCKET_COUNT];
+		std::atomic<uint64_t> count;
+		std::atomic<uint64_t> total_ticks;
+		std::atomic<uint64_t> max_ticks;
+		std::atomic<uint64_t> counter_totals[HardwareCounterCount];
+	};
+
+	/// <summary>
+	/// Every site's timings from one thread, indexed by site id.
+	/// Only the owning thread grows sites, and only while holding the registry lock.
+	/// </summary>
+	struct ThreadStats
+	{
+		std::vector<std::unique_ptr<SiteStats>> sites;
+	};
+
+	/// <summary>
+	/// Owns the calling thread's ThreadStats, and retires them when the thread exits
+	/// </summary>
+	struct ThreadStatsHolder
+	{
+		ThreadStatsHolder();
+		~ThreadStatsHolder();
+
+		ThreadStats *stats;
+	};
+
+	/// <summary>
+	/// Timings of a site merged across threads
+	/// </summary>
+	struct MergedStats
+	{
+		MergedStats();
+
+		std::vector<uint64_t> buckets;
+		uint64_t count;
+		uint64_t total_ticks;
+		uint64_t max_ticks;
+		uint64_t counter_totals[HardwareCounterCount];
+	};
+
+	/// <summary>
+	/// Site names, every live thread's timings, and the timings of exited threads by site id
+	/// </summary>
+	struct Registry
+	{
+		std::mutex lock;
+		std::vector<std::string> site_names;
+		std::unordered_map<std::string, size_t> site_ids;
+		std::vector<std::unique_ptr<ThreadStats>> thread_stats;
+		std::vector<std::unique_ptr<MergedStats>> retired;
+	};
+
+	static Registry &registry();
+	static SiteStats &siteStats(const size_t &site_id);
+	static void addHardwareCounters(const size_t &site_id, const uint64_t *deltas);
+	static bool readHardwareCounters(uint64_t *values);
+
+	static void retireThread(ThreadStats *thread);
+	static void foldInto(const SiteStats &stats, MergedStats &merged);
+	static MergedStats merge(const size_t &site_id);
+	static uint64_t percentileTicks(const MergedStats &stats, const double &percentile);
+	static size_t bucketIndex(const uint64_t &tick_count);
+	static uint64_t bucketHighestValue(const size_t &index);
+	static void bump(std::atomic<uint64_t> &value, const uint64_t &amount);
+
+	static std::atomic<bool> counters_enabled;
+};
+
+/// <summary>
+/// Times the scope it lives in and records the time to a Profiler site when it is destroyed.
+/// If hardware counters are enabled, also records the cycles, instructions and cache misses of the scope.
+/// </summary>
+class ScopedTimer
+{
+public:
+	ScopedTimer(const size_t &site_id);
+	ScopedTimer(const std::string &name);
+	~ScopedTimer();
+
+	ScopedTimer(const ScopedTimer &) = delete;
+	ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+	uint64_t elapsedNanoseconds() const;
+
+private:
+	void start();
+
+	size_t site_id;
+	bool counting;
+	uint64_t start_counters[Profiler::HardwareCounterCount];
+	uint64_t start_ticks;
+};
+
+#endif Profiler_H
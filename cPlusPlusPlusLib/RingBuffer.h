@@ -0,0 +1,591 @@
+/*
+* This is the header file for the RingBuffer classes of cPlusPlusPlusLib
+* cPPPLib - A library of functions that should be in the C++ Standard Library
+* (C) - Charles Machalow - MIT License
+*/
+
+#ifndef RingBuffer_H
+#define RingBuffer_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// <summary>
+/// Helpers shared by the lock-free ring buffers
+/// </summary>
+class RingBufferBase
+{
+public:
+	// Size that the hot indices are padded out to, so the producer and consumer sides never share a cache line
+	static const size_t CACHE_LINE_SIZE = 64;
+
+protected:
+	/// <summary>
+	/// Rounds a capacity up to a power of two (at least 2), so slots can be found with a mask
+	/// </summary>
+	/// <param name="capacity">The requested capacity</param>
+	/// <returns>The capacity to use</returns>
+	static size_t roundUpCapacity(const size_t &capacity)
+	{
+		size_t ret = 2;
+		while (ret < capacity)
+		{
+			ret <<= 1;
+		}
+		return ret;
+	}
+
+	/// <summary>
+	/// Waits a little before retrying a blocking operation: spins at first, then gives up the time slice
+	/// </summary>
+	/// <param name="spins">Number of times this wait has happened so far. Incremented</param>
+	static void backoff(size_t &spins)
+	{
+		if (++spins > 64)
+		{
+			std::this_thread::yield();
+		}
+	}
+};
+
+/// <summary>
+/// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+/// Each side keeps a cached copy of the other side's index, so it only touches the other side's cache line when the queue looks full (or empty).
+/// Batch operations publish a whole batch with a single index store.
+/// </summary>
+template <typename T> class SpscRingBuffer : public RingBufferBase
+{
+public:
+	/// <summary>
+	/// Constructor for a SpscRingBuffer
+	/// </summary>
+	/// <param name="capacity">Max number of items held at once, rounded up to a power of two</param>
+	SpscRingBuffer(const size_t &capacity)
+		: slots(roundUpCapacity(capacity)), mask(slots.size() - 1), tail(0), cached_head(0), head(0), cached_tail(0), is_closed(false)
+	{
+	}
+
+	SpscRingBuffer(const SpscRingBuffer &) = delete;
+	SpscRingBuffer &operator=(const SpscRingBuffer &) = delete;
+
+	/// <summary>
+	/// Adds an item if there is room. Producer only.
+	/// </summary>
+	/// <param name="item">The item to move in</param>
+	/// <returns>True if the item was added, False if the queue is full</returns>
+	bool tryPush(T &&item)
+	{
+		size_t current_tail = tail.load(std::memory_order_relaxed);
+		if (current_tail - cached_head == slots.size())
+		{
+			cached_head = head.load(std::memory_order_acquire);
+			if (current_tail - cached_head == slots.size())
+			{
+				return false;
+			}
+		}
+
+		slots[current_tail & mask] = std::move(item);
+		tail.store(current_tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// <summary>
+	/// Adds a copy of an item if there is room. Producer only.
+	/// </summary>
+	/// <param name="item">The item to copy in</param>
+	/// <returns>True if the item was added, False if the queue is full</returns>
+	bool tryPush(const T &item)
+	{
+		T copy = item;
+		return tryPush(std::move(copy));
+	}
+
+	/// <summary>
+	/// Adds as many items from an array as there is room for. Producer only.
+	/// </summary>
+	/// <param name="items">Pointer to the first item. Added items are moved from</param>
+	/// <param name="count">Number of items</param>
+	/// <returns>Number of items added (the first that many of items)</returns>
+	size_t tryPushBatch(T *items, const size_t &count)
+	{
+		size_t current_tail = tail.load(std::memory_order_relaxed);
+		size_t room = slots.size() - (current_tail - cached_head);
+		if (room < count)
+		{
+			cached_head = head.load(std::memory_order_acquire);
+			room = slots.size() - (current_tail - cached_head);
+		}
+
+		size_t pushed = std::min(room, count);
+		for (size_t i = 0; i < pushed; i++)
+		{
+			slots[(current_tail + i) & mask] = std::move(items[i]);
+		}
+
+		if (pushed > 0)
+		{
+			tail.store(current_tail + pushed, std::memory_order_release);
+		}
+		return pushed;
+	}
+
+	/// <summary>
+	/// Removes the oldest item if there is one. Consumer only.
+	/// </summary>
+	/// <param name="item">T, passed by reference. Gets the item moved into it</param>
+	/// <returns>True if an item was removed, False if the queue is empty</returns>
+	bool tryPop(T &item)
+	{
+		size_t current_head = head.load(std::memory_order_relaxed);
+		if (current_head == cached_tail)
+		{
+			cached_tail = tail.load(std::memory_order_acquire);
+			if (current_head == cached_tail)
+			{
+				return false;
+			}
+		}
+
+		item = std::move(slots[current_head & mask]);
+		head.store(current_head + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// <summary>
+	/// Removes up to max_count of the oldest items. Consumer only.
+	/// </summary>
+	/// <param name="items">Pointer to room for max_count items. Gets the items moved into it</param>
+	/// <param name="max_count">Max number of items to remove</param>
+	/// <returns>Number of items removed</returns>
+	size_t tryPopBatch(T *items, const size_t &max_count)
+	{
+		size_t current_head = head.load(std::memory_order_relaxed);
+		size_t available = cached_tail - current_head;
+		if (available < max_count)
+		{
+			cached_tail = tail.load(std::memory_order_acquire);
+			available = cached_tail - current_head;
+		}
+
+		size_t popped = std::min(available, max_count);
+		for (size_t i = 0; i < popped; i++)
+		{
+			items[i] = std::move(slots[(current_head + i) & mask]);
+		}
+
+		if (popped > 0)
+		{
+			head.store(current_head + popped, std::memory_order_release);
+		}
+		return popped;
+	}
+
+	/// <summary>
+	/// Adds an item, waiting for room. Producer only.
+	/// </summary>
+	/// <param name="item">The item to move in</param>
+	void push(T &&item)
+	{
+		size_t spins = 0;
+		while (!tryPush(std::move(item)))
+		{
+			backoff(spins);
+		}
+	}
+
+	/// <summary>
+	/// Adds every item from an array, waiting for room as needed. Producer only.
+	/// </summary>
+	/// <param name="items">Pointer to the first item. Items are moved from</param>
+	/// <param name="count">Number of items</param>
+	void pushBatch(T *items, const size_t &count)
+	{
+		size_t pushed = 0;
+		size_t spins = 0;
+		while (pushed < count)
+		{
+			size_t added = tryPushBatch(items + pushed, count - pushed);
+			if (added == 0)
+			{
+				backoff(spins);
+			}
+			pushed += added;
+		}
+	}
+
+	/// <summary>
+	/// Removes the oldest item, waiting for one unless the queue is closed. Consumer only.
+	/// </summary>
+	/// <param name="item">T, passed by reference. Gets the item moved into it</param>
+	/// <returns>True if an item was removed, False if the queue is closed and empty</returns>
+	bool pop(T &item)
+	{
+		size_t spins = 0;
+		while (!tryPop(item))
+		{
+			if (isClosed())
+			{
+				// Anything pushed before close() is visible now
+				return tryPop(item);
+			}
+			backoff(spins);
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// Removes between 1 and max_count of the oldest items, waiting for at least one unless the queue is closed. Consumer only.
+	/// </summary>
+	/// <param name="items">Pointer to room for max_count items. Gets the items moved into it</param>
+	/// <param name="max_count">Max number of items to remove</param>
+	/// <returns>Number of items removed. 0 only if the queue is closed and empty</returns>
+	size_t popBatch(T *items, const size_t &max_count)
+	{
+		size_t spins = 0;
+		while (true)
+		{
+			size_t popped = tryPopBatch(items, max_count);
+			if (popped > 0)
+			{
+				return popped;
+			}
+			if (isClosed())
+			{
+				return tryPopBatch(items, max_count);
+			}
+			backoff(spins);
+		}
+	}
+
+	/// <summary>
+	/// Marks that nothing more will be pushed, so waiting pops return once the queue drains. Producer only.
+	/// </summary>
+	void close()
+	{
+		is_closed.store(true, std::memory_order_release);
+	}
+
+	/// <summary>
+	/// Determines if close() has been called
+	/// </summary>
+	/// <returns>True if the queue is closed</returns>
+	bool isClosed() const
+	{
+		return is_closed.load(std::memory_order_acquire);
+	}
+
+	/// <summary>
+	/// Gets the max number of items held at once
+	/// </summary>
+	/// <returns>The capacity</returns>
+	size_t capacity() const
+	{
+		return slots.size();
+	}
+
+	/// <summary>
+	/// Gets the number of items held. Only a snapshot if the other side is running.
+	/// </summary>
+	/// <returns>Number of items held</returns>
+	size_t size() const
+	{
+		size_t current_head = head.load(std::memory_order_acquire);
+		return tail.load(std::memory_order_acquire) - current_head;
+	}
+
+private:
+	std::vector<T> slots;
+	const size_t mask;
+	char slots_pad[CACHE_LINE_SIZE];
+
+	// Producer side: written by the producer, read by the consumer only when it thinks the queue is empty
+	std::atomic<size_t> tail;
+	size_t cached_head;
+	char producer_pad[CACHE_LINE_SIZE];
+
+	// Consumer side: written by the consumer, read by the producer only when it thinks the queue is full
+	std::atomic<size_t> head;
+	size_t cached_tail;
+	char consumer_pad[CACHE_LINE_SIZE];
+
+	std::atomic<bool> is_closed;
+};
+
+/// <summary>
+/// Bounded lock-free queue for any number of producer and consumer threads (Vyukov's bounded MPMC queue).
+/// Every slot carries a sequence number saying whose turn it is, so producers and consumers only contend on their own index.
+/// Batch operations are a convenience here: each item still takes its own slot claim.
+/// </summary>
+template <typename T> class MpmcRingBuffer : public RingBufferBase
+{
+public:
+	/// <summary>
+	/// Constructor for a MpmcRingBuffer
+	/// </summary>
+	/// <param name="capacity">Max number of items held at once, rounded up to a power of two</param>
+	MpmcRingBuffer(const size_t &capacity)
+		: slot_count(roundUpCapacity(capacity)), mask(slot_count - 1), slots(new Slot[slot_count]), enqueue_pos(0), dequeue_pos(0), is_closed(false)
+	{
+		for (size_t i = 0; i < slot_count; i++)
+		{
+			slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	MpmcRingBuffer(const MpmcRingBuffer &) = delete;
+	MpmcRingBuffer &operator=(const MpmcRingBuffer &) = delete;
+
+	/// <summary>
+	/// Adds an item if there is room
+	/// </summary>
+	/// <param name="item">The item to move in</param>
+	/// <returns>True if the item was added, False if the queue is full</returns>
+	bool tryPush(T &&item)
+	{
+		size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+		Slot *slot = nullptr;
+
+		while (true)
+		{
+			slot = &slots[pos & mask];
+			size_t sequence = slot->sequence.load(std::memory_order_acquire);
+			intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+			if (diff == 0)
+			{
+				if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (diff < 0)
+			{
+				return false;
+			}
+			else
+			{
+				pos = enqueue_pos.load(std::memory_order_relaxed);
+			}
+		}
+
+		slot->data = std::move(item);
+		slot->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// <summary>
+	/// Adds a copy of an item if there is room
+	/// </summary>
+	/// <param name="item">The item to copy in</param>
+	/// <returns>True if the item was added, False if the queue is full</returns>
+	bool tryPush(const T &item)
+	{
+		T copy = item;
+		return tryPush(std::move(copy));
+	}
+
+	/// <summary>
+	/// Adds items from an array until the queue is full
+	/// </summary>
+	/// <param name="items">Pointer to the first item. Added items are moved from</param>
+	/// <param name="count">Number of items</param>
+	/// <returns>Number of items added (the first that many of items)</returns>
+	size_t tryPushBatch(T *items, const size_t &count)
+	{
+		size_t pushed = 0;
+		while (pushed < count && tryPush(std::move(items[pushed])))
+		{
+			pushed++;
+		}
+		return pushed;
+	}
+
+	/// <summary>
+	/// Removes the oldest item if there is one
+	/// </summary>
+	/// <param name="item">T, passed by reference. Gets the item moved into it</param>
+	/// <returns>True if an item was removed, False if the queue is empty</returns>
+	bool tryPop(T &item)
+	{
+		size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+		Slot *slot = nullptr;
+
+		while (true)
+		{
+			slot = &slots[pos & mask];
+			size_t sequence = slot->sequence.load(std::memory_order_acquire);
+			intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+
+			if (diff == 0)
+			{
+				if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (diff < 0)
+			{
+				return false;
+			}
+			else
+			{
+				pos = dequeue_pos.load(std::memory_order_relaxed);
+			}
+		}
+
+		item = std::move(slot->data);
+		slot->sequence.store(pos + slot_count, std::memory_order_release);
+		return true;
+	}
+
+	/// <summary>
+	/// Removes up to max_count of the oldest items
+	/// </summary>
+	/// <param name="items">Pointer to room for max_count items. Gets the items moved into it</param>
+	/// <param name="max_count">Max number of items to remove</param>
+	/// <returns>Number of items removed</returns>
+	size_t tryPopBatch(T *items, const size_t &max_count)
+	{
+		size_t popped = 0;
+		while (popped < max_count && tryPop(items[popped]))
+		{
+			popped++;
+		}
+		return popped;
+	}
+
+	/// <summary>
+	/// Adds an item, waiting for room
+	/// </summary>
+	/// <param name="item">The item to move in</param>
+	void push(T &&item)
+	{
+		size_t spins = 0;
+		while (!tryPush(std::move(item)))
+		{
+			backoff(spins);
+		}
+	}
+
+	/// <summary>
+	/// Adds every item from an array, waiting for room as needed
+	/// </summary>
+	/// <param name="items">Pointer to the first item. Items are moved from</param>
+	/// <param name="count">Number of items</param>
+	void pushBatch(T *items, const size_t &count)
+	{
+		size_t pushed = 0;
+		size_t spins = 0;
+		while (pushed < count)
+		{
+			size_t added = tryPushBatch(items + pushed, count - pushed);
+			if (added == 0)
+			{
+				backoff(spins);
+			}
+			pushed += added;
+		}
+	}
+
+	/// <summary>
+	/// Removes the oldest item, waiting for one unless the queue is closed
+	/// </summary>
+	/// <param name="item">T, passed by reference. Gets the item moved into it</param>
+	/// <returns>True if an item was removed, False if the queue is closed and empty</returns>
+	bool pop(T &item)
+	{
+		size_t spins = 0;
+		while (!tryPop(item))
+		{
+			if (isClosed())
+			{
+				return tryPop(item);
+			}
+			backoff(spins);
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// Removes between 1 and max_count of the oldest items, waiting for at least one unless the queue is closed
+	/// </summary>
+	/// <param name="items">Pointer to room for max_count items. Gets the items moved into it</param>
+	/// <param name="max_count">Max number of items to remove</param>
+	/// <returns>Number of items removed. 0 only if the queue is closed and empty</returns>
+	size_t popBatch(T *items, const size_t &max_count)
+	{
+		size_t spins = 0;
+		while (true)
+		{
+			size_t popped = tryPopBatch(items, max_count);
+			if (popped > 0)
+			{
+				return popped;
+			}
+			if (isClosed())
+			{
+				return tryPopBatch(items, max_count);
+			}
+			backoff(spins);
+		}
+	}
+
+	/// <summary>
+	/// Marks that nothing more will be pushed, so waiting pops return once the queue drains.
+	/// Call only after every producer has finished pushing.
+	/// </summary>
+	void close()
+	{
+		is_closed.store(true, std::memory_order_release);
+	}
+
+	/// <summary>
+	/// Determines if close() has been called
+	/// </summary>
+	/// <returns>True if the queue is closed</returns>
+	bool isClosed() const
+	{
+		return is_closed.load(std::memory_order_acquire);
+	}
+
+	/// <summary>
+	/// Gets the max number of items held at once
+	/// </summary>
+	/// <returns>The capacity</returns>
+	size_t capacity() const
+	{
+		return slot_count;
+	}
+
+private:
+	/// <summary>
+	/// A slot and its sequence number.
+	/// sequence == pos means free for the producer claiming pos, sequence == pos + 1 means full for the consumer claiming pos.
+	/// </summary>
+	struct Slot
+	{
+		std::atomic<size_t> sequence;
+		T data;
+	};
+
+	const size_t slot_count;
+	const size_t mask;
+	std::unique_ptr<Slot[]> slots;
+	char slots_pad[CACHE_LINE_SIZE];
+
+	std::atomic<size_t> enqueue_pos;
+	char enqueue_pad[CACHE_LINE_SIZE];
+
+	std::atomic<size_t> dequeue_pos;
+	char dequeue_pad[CACHE_LINE_SIZE];
+
+	std::atomic<bool> is_closed;
+};
+
+#endif RingBuffer_H
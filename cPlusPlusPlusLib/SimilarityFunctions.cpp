@@ -0,0 +1,421 @@
+/*
+* This is the cpp file for the SimilarityFunctions class of cPlusPlusPlusLib
+* cPPPLib - A library of functions that should be in the C++ Standard Library
+* (C) - Charles Machalow - MIT License
+*/
+
+#ifndef SimilarityFunctions_CPP
+#define SimilarityFunctions_CPP
+
+#include "SimilarityFunctions.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMILARITY_USE_SSE2
+#include <emmintrin.h>
+#endif //SSE2
+
+/// <summary>
+/// Prepares pattern for distance checks by building its match bit vectors
+/// </summary>
+/// <param name="pattern">The pattern. Not referenced after construction</param>
+SimilarityFunctions::Pattern::Pattern(const StringView &pattern)
+{
+	pattern_size = pattern.size();
+	block_count = (pattern_size + 63) / 64;
+	peq.assign(256 * block_count, 0);
+
+	// Bit i of the word for char c (in the block holding i) is set if pattern[i] == c
+	for (size_t i = 0; i < pattern_size; i++)
+	{
+		peq[static_cast<unsigned char>(pattern[i]) * block_count + i / 64] |= 1ULL << (i % 64);
+	}
+}
+
+/// <summary>
+/// Gets the Levenshtein distance from the pattern to text
+/// </summary>
+/// <param name="text">The text to compare with</param>
+/// <param name="max_distance">Largest distance of interest. Comparing stops as soon as the distance is known to be larger</param>
+/// <returns>The distance, or max_distance + 1 if it is larger than max_distance</returns>
+size_t SimilarityFunctions::Pattern::distance(const StringView &text, const size_t &max_distance) const
+{
+	if (!lengthsWithin(pattern_size, text.size(), max_distance))
+	{
+		return overBound(max_distance);
+	}
+
+	if (pattern_size == 0)
+	{
+		return text.size();
+	}
+
+	if (block_count == 1)
+	{
+		return singleWordDistance(peq.data(), pattern_size, text, max_distance);
+	}
+
+	return blockedDistance(peq.data(), pattern_size, block_count, text, max_distance);
+}
+
+/// <summary>
+/// Gets the Levenshtein distance from the pattern to each of several texts.
+/// With SSE2, texts are compared two at a time when the pattern is 64 chars or less.
+/// </summary>
+/// <param name="texts">Array of texts to compare with</param>
+/// <param name="count">Number of texts</param>
+/// <param name="max_distance">Largest distance of interest. Comparing a text stops as soon as its distance is known to be larger</param>
+/// <param name="out">Array of count distances, set to each text's distance (or max_distance + 1 where it is larger)</param>
+void SimilarityFunctions::Pattern::distances(const StringView *texts, const size_t &count, const size_t &max_distance, size_t *out) const
+{
+	distanceRange(*this, texts, max_distance, 0, count, out);
+}
+
+/// <summary>
+/// Gets the size of the pattern
+/// </summary>
+/// <returns>Size of the pattern in chars</returns>
+size_t SimilarityFunctions::Pattern::size() const
+{
+	return pattern_size;
+}
+
+/// <summary>
+/// Gets the Levenshtein (edit) distance between a and b: the fewest single char inserts, deletes and replacements turning one into the other
+/// </summary>
+/// <param name="a">The first string</param>
+/// <param name="b">The second string</param>
+/// <param name="max_distance">Largest distance of interest. Comparing stops as soon as the distance is known to be larger</param>
+/// <returns>The distance, or max_distance + 1 if it is larger than max_distance</returns>
+size_t SimilarityFunctions::levenshteinDistance(const StringView &a, const StringView &b, const size_t &max_distance)
+{
+	if (!lengthsWithin(a.size(), b.size(), max_distance))
+	{
+		return overBound(max_distance);
+	}
+
+	// The shorter string goes in the bit vectors, so more comparisons fit in one word
+	const StringView &shorter = a.size() <= b.size() ? a : b;
+	const StringView &longer = a.size() <= b.size() ? b : a;
+
+	// A shared prefix or suffix never changes the distance
+	size_t prefix = 0;
+	while (prefix < shorter.size() && shorter[prefix] == longer[prefix])
+	{
+		prefix++;
+	}
+
+	size_t suffix = 0;
+	while (suffix < shorter.size() - prefix && shorter[shorter.size() - 1 - suffix] == longer[longer.size() - 1 - suffix])
+	{
+		suffix++;
+	}
+
+	StringView pattern = shorter.substr(prefix, shorter.size() - prefix - suffix);
+	StringView text = longer.substr(prefix, longer.size() - prefix - suffix);
+
+	if (pattern.empty())
+	{
+		return text.size();
+	}
+
+	if (pattern.size() <= 64)
+	{
+		uint64_t peq[256];
+		memset(peq, 0, sizeof(peq));
+		for (size_t i = 0; i < pattern.size(); i++)
+		{
+			peq[static_cast<unsigned char>(pattern[i])] |= 1ULL << i;
+		}
+
+		return singleWordDistance(peq, pattern.size(), text, max_distance);
+	}
+
+	return Pattern(pattern).distance(text, max_distance);
+}
+
+/// <summary>
+/// Gets the Levenshtein distance from pattern to every candidate.
+/// With SSE2, candidates are compared two at a time when the pattern is 64 chars or less. Large batches are split across ThreadPool::shared().
+/// </summary>
+/// <param name="pattern">The pattern</param>
+/// <param name="candidates">The strings to compare the pattern with</param>
+/// <param name="max_distance">Largest distance of interest. Comparing a candidate stops as soon as its distance is known to be larger</param>
+/// <returns>std::vector with the distance to each candidate (max_distance + 1 where it is larger than max_distance)</returns>
+std::vector<size_t> SimilarityFunctions::levenshteinDistances(const StringView &pattern, const std::vector<std::string> &candidates, const size_t &max_distance)
+{
+	return levenshteinDistances(Pattern(pattern), candidates, max_distance);
+}
+
+/// <summary>
+/// Gets the Levenshtein distance from a prepared pattern to every candidate.
+/// With SSE2, candidates are compared two at a time when the pattern is 64 chars or less. Large batches are split across ThreadPool::shared().
+/// </summary>
+/// <param name="pattern">The prepared pattern</param>
+/// <param name="candidates">The strings to compare the pattern with</param>
+/// <param name="max_distance">Largest distance of interest. Comparing a candidate stops as soon as its distance is known to be larger</param>
+/// <returns>std::vector with the distance to each candidate (max_distance + 1 where it is larger than max_distance)</returns>
+std::vector<size_t> SimilarityFunctions::levenshteinDistances(const Pattern &pattern, const std::vector<std::string> &candidates, const size_t &max_distance)
+{
+	std::vector<size_t> ret_vec(candidates.size());
+	size_t *out = ret_vec.data();
+
+	if (candidates.size() < PARALLEL_BATCH_SIZE)
+	{
+		distanceRange(pattern, candidates.data(), max_distance, 0, candidates.size(), out);
+	}
+	else
+	{
+		ThreadPool::shared().parallelForRange(0, candidates.size(), [&pattern, &candidates, &max_distance, out](const size_t &begin, const size_t &end)
+		{
+			distanceRange(pattern, candidates.data(), max_distance, begin, end, out);
+		}, PARALLEL_BATCH_SIZE / 4);
+	}
+
+	return ret_vec;
+}
+
+/// <summary>
+/// Gets how similar a and b are, from their Levenshtein distance scaled by the longer one's size
+/// </summary>
+/// <param name="a">The first string</param>
+/// <param name="b">The second string</param>
+/// <returns>1.0 for equal strings down to 0.0 for strings with nothing in common</returns>
+double SimilarityFunctions::similarity(const StringView &a, const StringView &b)
+{
+	size_t longest = std::max(a.size(), b.size());
+	if (longest == 0)
+	{
+		return 1.0;
+	}
+
+	return 1.0 - static_cast<double>(levenshteinDistance(a, b)) / static_cast<double>(longest);
+}
+
+/// <summary>
+/// Checks if two sizes are close enough for their strings to be within max_distance edits
+/// </summary>
+/// <param name="a_size">Size of the first string</param>
+/// <param name="b_size">Size of the second string</param>
+/// <param name="max_distance">The largest distance of interest</param>
+/// <returns>True if the size difference is at most max_distance</returns>
+bool SimilarityFunctions::lengthsWithin(const size_t &a_size, const size_t &b_size, const size_t &max_distance)
+{
+	return (a_size > b_size ? a_size - b_size : b_size - a_size) <= max_distance;
+}
+
+/// <summary>
+/// Gets the value returned for a distance over max_distance
+/// </summary>
+/// <param name="max_distance">The largest distance of interest</param>
+/// <returns>max_distance + 1</returns>
+size_t SimilarityFunctions::overBound(const size_t &max_distance)
+{
+	// Nothing is over an unlimited bound; this just keeps the + 1 from wrapping
+	return max_distance == StringView::npos ? max_distance : max_distance + 1;
+}
+
+/// <summary>
+/// Myers' bit-parallel Levenshtein distance for a pattern of 1 to 64 chars
+/// </summary>
+/// <param name="peq">Match bit vector of the pattern for each char value</param>
+/// <param name="pattern_size">Size of the pattern (1 to 64)</param>
+/// <param name="text">The text to compare with</param>
+/// <param name="max_distance">The largest distance of interest</param>
+/// <returns>The distance, or max_distance + 1 if it is larger than max_distance</returns>
+size_t SimilarityFunctions::singleWordDistance(const uint64_t *peq, const size_t &pattern_size, const StringView &text, const size_t &max_distance)
+{
+	SingleWordState state;
+	state.pv = ~0ULL;
+	state.mv = 0;
+	state.score = pattern_size;
+	return singleWordDistance(peq, pattern_size, text, max_distance, state, 0);
+}
+
+/// <summary>
+/// Myers' bit-parallel Levenshtein distance for a pattern of 1 to 64 chars, carrying on from a state part way through text.
+/// pv and mv hold the vertical deltas (+1 / -1) of the current column of the edit distance matrix, one bit per pattern char.
+/// </summary>
+/// <param name="peq">Match bit vector of the pattern for each char value</param>
+/// <param name="pattern_size">Size of the pattern (1 to 64)</param>
+/// <param name="text">The text to compare with</param>
+/// <param name="max_distance">The largest distance of interest</param>
+/// <param name="state">State after the chars of text before start</param>
+/// <param name="start">Index in text to carry on from</param>
+/// <returns>The distance, or max_distance + 1 if it is larger than max_distance</returns>
+size_t SimilarityFunctions::singleWordDistance(const uint64_t *peq, const size_t &pattern_size, const StringView &text, const size_t &max_distance, SingleWordState state, const size_t &start)
+{
+	const size_t last_shift = pattern_size - 1;
+	const size_t text_size = text.size();
+	uint64_t pv = state.pv;
+	uint64_t mv = state.mv;
+	size_t score = state.score;
+
+	for (size_t j = start; j < text_size; j++)
+	{
+		uint64_t eq = peq[static_cast<unsigned char>(text[j])];
+		uint64_t xv = eq | mv;
+		uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+		uint64_t ph = mv | ~(xh | pv);
+		uint64_t mh = pv & xh;
+
+		// ph and mh never share a bit, so this is score + 1, score - 1 or score with no branch to mispredict
+		score += (ph >> last_shift) & 1;
+		score -= (mh >> last_shift) & 1;
+
+		// Each remaining char can lower the score by at most 1
+		size_t remaining = text_size - j - 1;
+		if (score > remaining && score - remaining > max_distance)
+		{
+			return overBound(max_distance);
+		}
+
+		ph = (ph << 1) | 1;
+		mh <<= 1;
+		pv = mh | ~(xv | ph);
+		mv = ph & xv;
+	}
+
+	return score > max_distance ? overBound(max_distance) : score;
+}
+
+/// <summary>
+/// Myers' bit-parallel Levenshtein distance for a pattern of any size, using 64 char blocks chained by their horizontal deltas (Hyyrö's extension)
+/// </summary>
+/// <param name="peq">Match bit vectors of the pattern, block_count words per char value</param>
+/// <param name="pattern_size">Size of the pattern</param>
+/// <param name="block_count">Number of 64 char blocks in the pattern</param>
+/// <param name="text">The text to compare with</param>
+/// <param name="max_distance">The largest distance of interest</param>
+/// <returns>The distance, or max_distance + 1 if it is larger than max_distance</returns>
+size_t SimilarityFunctions::blockedDistance(const uint64_t *peq, const size_t &pattern_size, const size_t &block_count, const StringView &text, const size_t &max_distance)
+{
+	std::vector<uint64_t> pv(block_count, ~0ULL);
+	std::vector<uint64_t> mv(block_count, 0);
+	const uint64_t last = 1ULL << ((pattern_size - 1) % 64);
+	const size_t text_size = text.size();
+	size_t score = pattern_size;
+
+	for (size_t j = 0; j < text_size; j++)
+	{
+		const uint64_t *eqs = peq + static_cast<unsigned char>(text[j]) * block_count;
+
+		// The first row of the matrix goes up by 1 per column
+		int carry = 1;
+		for (size_t b = 0; b < block_count; b++)
+		{
+			uint64_t high = b + 1 == block_count ? last : 1ULL << 63;
+			uint64_t eq = eqs[b];
+			uint64_t xv = eq | mv[b];
+			if (carry < 0)
+			{
+				eq |= 1;
+			}
+
+			uint64_t xh = (((eq & pv[b]) + pv[b]) ^ pv[b]) | eq;
+			uint64_t ph = mv[b] | ~(xh | pv[b]);
+			uint64_t mh = pv[b] & xh;
+			int carry_out = (ph & high) ? 1 : ((mh & high) ? -1 : 0);
+
+			ph <<= 1;
+			mh <<= 1;
+			if (carry < 0)
+			{
+				mh |= 1;
+			}
+			else if (carry > 0)
+			{
+				ph |= 1;
+			}
+
+			pv[b] = mh | ~(xv | ph);
+			mv[b] = ph & xv;
+			carry = carry_out;
+		}
+
+		if (carry > 0)
+		{
+			score++;
+		}
+		else if (carry < 0)
+		{
+			score--;
+		}
+
+		size_t remaining = text_size - j - 1;
+		if (score > remaining && score - remaining > max_distance)
+		{
+			return overBound(max_distance);
+		}
+	}
+
+	return score > max_distance ? overBound(max_distance) : score;
+}
+
+/// <summary>
+/// Gets the distance from a pattern of 1 to 64 chars to two texts at once: text_a in the low lane of SSE2 registers and text_b in the high lane.
+/// The lanes run together over the shorter text's size, then the longer text is finished on its own.
+/// Without SSE2 the texts are compared one after the other.
+/// </summary>
+/// <param name="peq">Match bit vector of the pattern for each char value</param>
+/// <param name="pattern_size">Size of the pattern (1 to 64)</param>
+/// <param name="text_a">The first text</param>
+/// <param name="text_b">The second text</param>
+/// <param name="max_distance">The largest distance of interest</param>
+/// <param name="distance_a">Set to the distance to text_a (or max_distance + 1 if larger)</param>
+/// <param name="distance_b">Set to the distance to text_b (or max_distance + 1 if larger)</param>
+void SimilarityFunctions::singleWordDistancePair(const uint64_t *peq, const size_t &pattern_size, const StringView &text_a, const StringView &text_b, const size_t &max_distance, size_t &distance_a, size_t &distance_b)
+{
+#ifdef SIMILARITY_USE_SSE2
+	const size_t common = std::min(text_a.size(), text_b.size());
+	const __m128i all_ones = _mm_set1_epi32(-1);
+	const __m128i low_bits = _mm_set_epi64x(1, 1);
+	const __m128i last_shift = _mm_cvtsi32_si128(static_cast<int>(pattern_size - 1));
+	__m128i pv = all_ones;
+	__m128i mv = _mm_setzero_si128();
+	__m128i score = _mm_set_epi64x(static_cast<long long>(pattern_size), static_cast<long long>(pattern_size));
+
+	for (size_t j = 0; j < common; j++)
+	{
+		__m128i eq = _mm_set_epi64x(static_cast<long long>(peq[static_cast<unsigned char>(text_b[j])]), static_cast<long long>(peq[static_cast<unsigned char>(text_a[j])]));
+		__m128i xv = _mm_or_si128(eq, mv);
+		__m128i xh = _mm_or_si128(_mm_xor_si128(_mm_add_epi64(_mm_and_si128(eq, pv), pv), pv), eq);
+		__m128i ph = _mm_or_si128(mv, _mm_andnot_si128(_mm_or_si128(xh, pv), all_ones));
+		__m128i mh = _mm_and_si128(pv, xh);
+
+		// Same branch free score update as the scalar loop
+		score = _mm_add_epi64(score, _mm_and_si128(_mm_srl_epi64(ph, last_shift), low_bits));
+		score = _mm_sub_epi64(score, _mm_and_si128(_mm_srl_epi64(mh, last_shift), low_bits));
+
+		ph = _mm_or_si128(_mm_slli_epi64(ph, 1), low_bits);
+		mh = _mm_slli_epi64(mh, 1);
+		pv = _mm_or_si128(mh, _mm_andnot_si128(_mm_or_si128(xv, ph), all_ones));
+		mv = _mm_and_si128(ph, xv);
+	}
+
+	uint64_t pv_lanes[2];
+	uint64_t mv_lanes[2];
+	uint64_t score_lanes[2];
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(pv_lanes), pv);
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(mv_lanes), mv);
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(score_lanes), score);
+
+	SingleWordState state;
+	state.pv = pv_lanes[0];
+	state.mv = mv_lanes[0];
+	state.score = static_cast<size_t>(score_lanes[0]);
+	distance_a = singleWordDistance(peq, pattern_size, text_a, max_distance, state, common);
+
+	state.pv = pv_lanes[1];
+	state.mv = mv_lanes[1];
+	state.score = static_cast<size_t>(score_lanes[1]);
+	distance_b = singleWordDistance(peq, pattern_size, text_b, max_distance, state, common);
+#else
+	distance_a = singleWordDistance(peq, pattern_size, text_a, max_distance);
+	distance_b = singleWordDistance(peq, pattern_size, text_b, max_distance);
+#endif //SIMILARITY_USE_SSE2
+}
+
+#endif SimilarityFunctions_CPP
@@ -0,0 +1,117 @@
+/*
+* This is the header file for the SimilarityFunctions class of cPlusPlusPlusLib
+* cPPPLib - A library of functions that should be in the C++ Standard Library
+* (C) - Charles Machalow - MIT License
+*/
+
+#ifndef SimilarityFunctions_H
+#define SimilarityFunctions_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "StringView.h"
+#include "ThreadPool.h"
+
+/// <summary>
+/// Class for functions comparing std::strings for similarity.
+/// Edit distances are bit-parallel (Myers' algorithm): each char of one string is compared against up to 64 chars of the other at once.
+/// Distances are counted in bytes, so a multi-byte UTF-8 char counts as several edits.
+/// </summary>
+class SimilarityFunctions
+{
+public:
+	/// <summary>
+	/// A string prepared for repeated Levenshtein distance checks against other strings
+	/// </summary>
+	class Pattern
+	{
+	public:
+		Pattern(const StringView &pattern);
+
+		size_t distance(const StringView &text, const size_t &max_distance = StringView::npos) const;
+		void distances(const StringView *texts, const size_t &count, const size_t &max_distance, size_t *out) const;
+		size_t size() const;
+
+	private:
+		friend class SimilarityFunctions;
+
+		std::vector<uint64_t> peq;
+		size_t pattern_size;
+		size_t block_count;
+	};
+
+	static size_t levenshteinDistance(const StringView &a, const StringView &b, const size_t &max_distance = StringView::npos);
+	static std::vector<size_t> levenshteinDistances(const StringView &pattern, const std::vector<std::string> &candidates, const size_t &max_distance = StringView::npos);
+	static std::vector<size_t> levenshteinDistances(const Pattern &pattern, const std::vector<std::string> &candidates, const size_t &max_distance = StringView::npos);
+	static double similarity(const StringView &a, const StringView &b);
+
+private:
+	// Batches at least this big are split across ThreadPool::shared()
+	static const size_t PARALLEL_BATCH_SIZE = 16384;
+
+	/// <summary>
+	/// Column state of a single word (pattern of 64 chars or less) Myers run
+	/// </summary>
+	struct SingleWordState
+	{
+		uint64_t pv;
+		uint64_t mv;
+		size_t score;
+	};
+
+	static bool lengthsWithin(const size_t &a_size, const size_t &b_size, const size_t &max_distance);
+	static size_t overBound(const size_t &max_distance);
+	static size_t singleWordDistance(const uint64_t *peq, const size_t &pattern_size, const StringView &text, const size_t &max_distance);
+	static size_t singleWordDistance(const uint64_t *peq, const size_t &pattern_size, const StringView &text, const size_t &max_distance, SingleWordState state, const size_t &start);
+	static size_t blockedDistance(const uint64_t *peq, const size_t &pattern_size, const size_t &block_count, const StringView &text, const size_t &max_distance);
+	static void singleWordDistancePair(const uint64_t *peq, const size_t &pattern_size, const StringView &text_a, const StringView &text_b, const size_t &max_distance, size_t &distance_a, size_t &distance_b);
+
+	/// <summary>
+	/// Gets the distance from pattern to texts[begin, end) into out[begin, end).
+	/// For patterns of 64 chars or less, texts that pass the size check are paired up for singleWordDistancePair().
+	/// </summary>
+	/// <param name="pattern">The prepared pattern</param>
+	/// <param name="texts">Array of texts (std::string or StringView)</param>
+	/// <param name="max_distance">The largest distance of interest</param>
+	/// <param name="begin">First text index</param>
+	/// <param name="end">One past the last text index</param>
+	/// <param name="out">Array of distances, indexed like texts</param>
+	template <typename Text> static void distanceRange(const Pattern &pattern, const Text *texts, const size_t &max_distance, const size_t &begin, const size_t &end, size_t *out)
+	{
+		if (pattern.block_count != 1)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				out[i] = pattern.distance(texts[i], max_distance);
+			}
+			return;
+		}
+
+		size_t waiting = end;
+		for (size_t i = begin; i < end; i++)
+		{
+			if (!lengthsWithin(pattern.pattern_size, texts[i].size(), max_distance))
+			{
+				out[i] = overBound(max_distance);
+			}
+			else if (waiting == end)
+			{
+				waiting = i;
+			}
+			else
+			{
+				singleWordDistancePair(pattern.peq.data(), pattern.pattern_size, texts[waiting], texts[i], max_distance, out[waiting], out[i]);
+				waiting = end;
+			}
+		}
+
+		if (waiting != end)
+		{
+			out[waiting] = pattern.distance(texts[waiting], max_distance);
+		}
+	}
+};
+
+#endif SimilarityFunctions_H
@@ -0,0 +1,393 @@
+/*
+* This is the header file for the SmallVector class of cPlusPlusPlusLib
+* cPPPLib - A library of functions that should be in the C++ Standard Library
+* (C) - Charles Machalow - MIT License
+*/
+
+#ifndef SmallVector_H
+#define SmallVector_H
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// <summary>
+/// Vector that keeps its first N elements inside the object itself, so short results need no heap allocation.
+/// Once more than N elements are added, the elements move to the heap and it behaves like a std::vector.
+/// Iterators and pointers are invalidated by anything that grows it, and by moves while the elements are inline.
+/// Growing gives the strong exception guarantee, like std::vector: if an element's constructor throws, the SmallVector is left as it was.
+/// </summary>
+template <typename T, size_t N> class SmallVector
+{
+	static_assert(N > 0, "SmallVector needs room for at least one inline element");
+
+public:
+	typedef T value_type;
+	typedef T *iterator;
+	typedef const T *const_iterator;
+
+	/// <summary>
+	/// Creates an empty SmallVector using only inline storage
+	/// </summary>
+	SmallVector() : items(inlineData()), item_count(0), item_capacity(N) {}
+
+	/// <summary>
+	/// Creates a SmallVector holding copies of the given items
+	/// </summary>
+	/// <param name="init">The items</param>
+	SmallVector(std::initializer_list<T> init) : SmallVector()
+	{
+		reserve(init.size());
+		for (const T &item : init)
+		{
+			push_back(item);
+		}
+	}
+
+	/// <summary>
+	/// Copy constructor
+	/// </summary>
+	/// <param name="other">The SmallVector to copy</param>
+	SmallVector(const SmallVector &other) : SmallVector()
+	{
+		reserve(other.item_count);
+		for (const T &item : other)
+		{
+			push_back(item);
+		}
+	}
+
+	/// <summary>
+	/// Move constructor. Heap storage is taken over, inline elements are moved one by one.
+	/// </summary>
+	/// <param name="other">The SmallVector to move from. Left empty</param>
+	SmallVector(SmallVector &&other) : SmallVector()
+	{
+		takeFrom(other);
+	}
+
+	/// <summary>
+	/// Destructor. Destroys the elements and frees any heap storage.
+	/// </summary>
+	~SmallVector()
+	{
+		clear();
+		freeStorage();
+	}
+
+	/// <summary>
+	/// Copy assignment
+	/// </summary>
+	/// <param name="other">The SmallVector to copy</param>
+	/// <returns>This SmallVector</returns>
+	SmallVector &operator=(const SmallVector &other)
+	{
+		if (this != &other)
+		{
+			clear();
+			reserve(other.item_count);
+			for (const T &item : other)
+			{
+				push_back(item);
+			}
+		}
+		return *this;
+	}
+
+	/// <summary>
+	/// Move assignment
+	/// </summary>
+	/// <param name="other">The SmallVector to move from. Left empty</param>
+	/// <returns>This SmallVector</returns>
+	SmallVector &operator=(SmallVector &&other)
+	{
+		if (this != &other)
+		{
+			clear();
+			freeStorage();
+			takeFrom(other);
+		}
+		return *this;
+	}
+
+	/// <summary>
+	/// Adds a copy of value to the end
+	/// </summary>
+	/// <param name="value">The value to add</param>
+	void push_back(const T &value)
+	{
+		emplace_back(value);
+	}
+
+	/// <summary>
+	/// Moves value onto the end
+	/// </summary>
+	/// <param name="value">The value to add</param>
+	void push_back(T &&value)
+	{
+		emplace_back(std::move(value));
+	}
+
+	/// <summary>
+	/// Constructs an element in place at the end
+	/// </summary>
+	/// <param name="args">Arguments for T's constructor</param>
+	/// <returns>Reference to the new element</returns>
+	template <typename... Args> T &emplace_back(Args &&... args)
+	{
+		if (item_count == item_capacity)
+		{
+			// Build the new element before moving the old ones, since args may refer to one of them
+			size_t new_capacity = item_capacity * 2;
+			T *new_items = allocate(new_capacity);
+			try
+			{
+				new (new_items + item_count) T(std::forward<Args>(args)...);
+			}
+			catch (...)
+			{
+				::operator delete(new_items);
+				throw;
+			}
+
+			try
+			{
+				moveInto(new_items);
+			}
+			catch (...)
+			{
+				new_items[item_count].~T();
+				::operator delete(new_items);
+				throw;
+			}
+			freeStorage();
+			items = new_items;
+			item_capacity = new_capacity;
+		}
+		else
+		{
+			new (items + item_count) T(std::forward<Args>(args)...);
+		}
+
+		return items[item_count++];
+	}
+
+	/// <summary>
+	/// Removes the last element. The SmallVector must not be empty.
+	/// </summary>
+	void pop_back()
+	{
+		items[--item_count].~T();
+	}
+
+	/// <summary>
+	/// Destroys every element. Heap storage (if any) is kept for reuse.
+	/// </summary>
+	void clear()
+	{
+		for (size_t i = 0; i < item_count; i++)
+		{
+			items[i].~T();
+		}
+		item_count = 0;
+	}
+
+	/// <summary>
+	/// Makes sure at least capacity elements fit without reallocating
+	/// </summary>
+	/// <param name="capacity">The capacity needed</param>
+	void reserve(const size_t &capacity)
+	{
+		if (capacity > item_capacity)
+		{
+			T *new_items = allocate(capacity);
+			try
+			{
+				moveInto(new_items);
+			}
+			catch (...)
+			{
+				::operator delete(new_items);
+				throw;
+			}
+			freeStorage();
+			items = new_items;
+			item_capacity = capacity;
+		}
+	}
+
+	/// <summary>
+	/// Grows (with value initialized elements) or shrinks to the given size
+	/// </summary>
+	/// <param name="size">The new size</param>
+	void resize(const size_t &size)
+	{
+		reserve(size);
+		while (item_count > size)
+		{
+			pop_back();
+		}
+		while (item_count < size)
+		{
+			emplace_back();
+		}
+	}
+
+	size_t size() const { return item_count; }
+	size_t capacity() const { return item_capacity; }
+	bool empty() const { return item_count == 0; }
+
+	/// <summary>
+	/// Checks if the elements are still held inline (no heap allocation has happened)
+	/// </summary>
+	/// <returns>True if the elements are inline</returns>
+	bool isInline() const { return items == inlineData(); }
+
+	T *data() { return items; }
+	const T *data() const { return items; }
+	iterator begin() { return items; }
+	iterator end() { return items + item_count; }
+	const_iterator begin() const { return items; }
+	const_iterator end() const { return items + item_count; }
+	T &operator[](const size_t &index) { return items[index]; }
+	const T &operator[](const size_t &index) const { return items[index]; }
+	T &front() { return items[0]; }
+	const T &front() const { return items[0]; }
+	T &back() { return items[item_count - 1]; }
+	const T &back() const { return items[item_count - 1]; }
+
+	/// <summary>
+	/// Bounds checked element access
+	/// </summary>
+	/// <param name="index">The index of the element</param>
+	/// <returns>Reference to the element</returns>
+	T &at(const size_t &index)
+	{
+		if (index >= item_count)
+		{
+			throw std::out_of_range("SmallVector index out of range");
+		}
+		return items[index];
+	}
+
+	/// <summary>
+	/// Bounds checked element access
+	/// </summary>
+	/// <param name="index">The index of the element</param>
+	/// <returns>Reference to the element</returns>
+	const T &at(const size_t &index) const
+	{
+		if (index >= item_count)
+		{
+			throw std::out_of_range("SmallVector index out of range");
+		}
+		return items[index];
+	}
+
+	/// <summary>
+	/// Copies the elements into a std::vector
+	/// </summary>
+	/// <returns>std::vector of the elements</returns>
+	std::vector<T> toVector() const
+	{
+		return std::vector<T>(begin(), end());
+	}
+
+	bool operator==(const SmallVector &other) const
+	{
+		return item_count == other.item_count && std::equal(begin(), end(), other.begin());
+	}
+
+	bool operator!=(const SmallVector &other) const
+	{
+		return !(*this == other);
+	}
+
+private:
+	T *inlineData() { return reinterpret_cast<T *>(&inline_storage); }
+	const T *inlineData() const { return reinterpret_cast<const T *>(&inline_storage); }
+
+	static T *allocate(const size_t &capacity)
+	{
+		return static_cast<T *>(::operator new(capacity * sizeof(T)));
+	}
+
+	/// <summary>
+	/// Frees heap storage, if any, and goes back to inline storage. Elements must already be destroyed or moved out.
+	/// </summary>
+	void freeStorage()
+	{
+		if (!isInline())
+		{
+			::operator delete(items);
+			items = inlineData();
+			item_capacity = N;
+		}
+	}
+
+	/// <summary>
+	/// Moves every element into new_items and destroys the originals. item_count is left as is.
+	/// Elements whose move constructor may throw are copied instead (if they can be), like std::vector does.
+	/// If a constructor throws, whatever was built in new_items is destroyed and the originals are left in place.
+	/// </summary>
+	/// <param name="new_items">Uninitialized storage with room for item_count elements</param>
+	void moveInto(T *new_items)
+	{
+		size_t built = 0;
+		try
+		{
+			for (; built < item_count; built++)
+			{
+				new (new_items + built) T(std::move_if_noexcept(items[built]));
+			}
+		}
+		catch (...)
+		{
+			for (size_t i = 0; i < built; i++)
+			{
+				new_items[i].~T();
+			}
+			throw;
+		}
+
+		for (size_t i = 0; i < item_count; i++)
+		{
+			items[i].~T();
+		}
+	}
+
+	/// <summary>
+	/// Takes other's elements. This SmallVector must be empty and inline.
+	/// </summary>
+	/// <param name="other">The SmallVector to take from. Left empty and inline</param>
+	void takeFrom(SmallVector &other)
+	{
+		if (other.isInline())
+		{
+			other.moveInto(items);
+			item_count = other.item_count;
+			other.item_count = 0;
+		}
+		else
+		{
+			items = other.items;
+			item_count = other.item_count;
+			item_capacity = other.item_capacity;
+			other.items = other.inlineData();
+			other.item_count = 0;
+			other.item_capacity = N;
+		}
+	}
+
+	T *items;
+	size_t item_count;
+	size_t item_capacity;
+	typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type inline_storage;
+};
+
+#endif SmallVector_H
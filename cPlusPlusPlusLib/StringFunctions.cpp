@@ -9,6 +9,10 @@
 
 #include "StringFunctions.h"
 
+#include "CsvParser.h"
+#include "NumberFunctions.h"
+#include "StringPool.h"
+
 /// <summary>
 /// Splits the original_str into a std::vector by delimiter
 /// </summary>
@@ -27,7 +31,7 @@ std::vector<std::string> StringFunctions::splitIntoVector(const std::string &ori
 		if (loc != std::string::npos)
 		{
 			ret_vec.push_back(working_str.substr(0, loc));
-			working_str = working_str.substr(loc + 1);
+			working_str = working_str.substr(loc + std::max(delim.size(), static_cast<size_t>(1)));
 		}
 		else
 		{
@@ -112,6 +116,38 @@ std::vector<std::string> StringFunctions::splitIntoVectorByWhitespace(const std:
 	return ret_vec;
 }
 
+/// <summary>
+/// Splits a delimited record (one line of CSV by default) into a vector, honoring quotes.
+/// Quoted fields may hold the delimiter, line breaks and doubled quote chars.
+/// </summary>
+/// <param name="record">The original std::string holding one record</param>
+/// <param name="delim">Char separating fields (Defaults to ',')</param>
+/// <param name="quote">Char used to quote fields (Defaults to '"')</param>
+/// <returns>std::vector<std::string> of the unquoted fields of the first record in record. Empty if it is malformed</returns>
+std::vector<std::string> StringFunctions::splitDelimitedRecord(const std::string &record, const char &delim, const char &quote)
+{
+	std::vector<std::string> ret_vec;
+	std::vector<StringView> fields;
+	CsvParser parser(record, delim, quote);
+
+	if (!parser.nextRecord(fields))
+	{
+		if (parser.failed())
+		{
+			std::cerr << "ERROR: Malformed field at offset " << parser.errorOffset() << " in record " << record << std::endl;
+		}
+		return ret_vec;
+	}
+
+	ret_vec.resize(fields.size());
+	for (size_t i = 0; i < fields.size(); i++)
+	{
+		parser.unescape(fields[i], ret_vec[i]);
+	}
+
+	return ret_vec;
+}
+
 /// <summary>
 /// Partitions the original std::string into a std::vector<std::string>.
 /// </summary>
@@ -128,20 +164,7 @@ std::vector<std::string> StringFunctions::splitIntoVectorByWhitespace(const std:
 /// </returns>
 std::vector<std::string> StringFunctions::partitionIntoVector(const std::string &original_str, const std::string &sep)
 {
-	size_t sep_loc = original_str.find(sep);
-
-	if (sep.size() > original_str.size() || sep_loc == std::string::npos)
-	{
-		std::vector<std::string> ret_vec = { original_str, "", "" };
-		return ret_vec;
-	}
-
-	std::vector<std::string> ret_vec;
-	ret_vec.push_back(original_str.substr(0, sep_loc));
-	ret_vec.push_back(sep);
-	ret_vec.push_back(original_str.substr(sep_loc + sep.size()));
-
-	return ret_vec;
+	return partition(original_str, sep).toVector();
 }
 
 /// <summary>
@@ -160,65 +183,226 @@ std::vector<std::string> StringFunctions::partitionIntoVector(const std::string
 /// </returns>
 std::vector<std::string> StringFunctions::rpartitionIntoVector(const std::string &original_str, const std::string &sep)
 {
-	size_t sep_loc = original_str.rfind(sep);
+	return rpartition(original_str, sep).toVector();
+}
+
+/// <summary>
+/// Splits the original_str by delimiter without copying: each token is a StringView into original_str.
+/// Up to 8 tokens are returned without any heap allocation.
+/// </summary>
+/// <param name="original_str">The original std::string. Must outlive the returned StringViews</param>
+/// <param name="delim">The delimiter.</param>
+/// <returns>SmallVector of StringViews, one per token, in the same order splitIntoVector() would return them</returns>
+SmallVector<StringView, 8> StringFunctions::splitIntoViews(const std::string &original_str, const std::string &delim)
+{
+	SmallVector<StringView, 8> ret_vec;
+	size_t step = std::max(delim.size(), static_cast<size_t>(1));
+	size_t pos = 0;
 
-	if (sep.size() > original_str.size() || sep_loc == std::string::npos)
+	while (pos < original_str.size())
 	{
-		std::vector<std::string> ret_vec = { original_str, "", "" };
-		return ret_vec;
+		size_t loc = original_str.find(delim, pos);
+		// found in string
+		if (loc != std::string::npos)
+		{
+			ret_vec.push_back(StringView(original_str.data() + pos, loc - pos));
+			pos = loc + step;
+		}
+		else
+		{
+			ret_vec.push_back(StringView(original_str.data() + pos, original_str.size() - pos));
+			break;
+		}
 	}
 
-	std::vector<std::string> ret_vec;
-	ret_vec.push_back(original_str.substr(0, sep_loc));
-	ret_vec.push_back(sep);
-	ret_vec.push_back(original_str.substr(sep_loc + sep.size()));
+	return ret_vec;
+}
 
+/// <summary>
+/// Checks if the separator was found
+/// </summary>
+/// <returns>True if the separator was found</returns>
+bool StringFunctions::Partition::found() const
+{
+	// sep views into the partitioned std::string when found (even if it is empty) and is null otherwise
+	return sep.data() != nullptr;
+}
+
+/// <summary>
+/// Gets a part of the Partition by index, like the std::vector returned by partitionIntoVector()
+/// </summary>
+/// <param name="index">0 for head, 1 for sep, 2 for tail</param>
+/// <returns>The part</returns>
+const StringView &StringFunctions::Partition::operator[](const size_t &index) const
+{
+	if (index == 0)
+	{
+		return head;
+	}
+	else if (index == 1)
+	{
+		return sep;
+	}
+	else if (index == 2)
+	{
+		return tail;
+	}
+
+	throw std::out_of_range("Partition index must be 0, 1 or 2");
+}
+
+/// <summary>
+/// Copies the Partition into a std::vector<std::string>, in the form partitionIntoVector() returns
+/// </summary>
+/// <returns>A std::vector<std::string> of head, sep and tail</returns>
+std::vector<std::string> StringFunctions::Partition::toVector() const
+{
+	std::vector<std::string> ret_vec = { head.str(), sep.str(), tail.str() };
 	return ret_vec;
 }
 
 /// <summary>
-/// Returns a copy of the given string in Title Case
+/// Partitions the original std::string at the first separator, without copying or allocating.
+/// </summary>
+/// <param name="original_str">The original std::string. Must outlive the returned Partition</param>
+/// <param name="sep">The separator std::string</param>
+/// <returns>
+/// A Partition of StringViews into original_str:
+/// head -> before separator if found
+/// sep -> separator if found
+/// tail -> after separator if found
+/// If the separator is not in the original std::string, head views all of it and the other 2 are empty.
+/// </returns>
+StringFunctions::Partition StringFunctions::partition(const std::string &original_str, const std::string &sep)
+{
+	return makePartition(original_str, original_str.find(sep), sep.size());
+}
+
+/// <summary>
+/// Partitions the original std::string at the last separator, without copying or allocating.
+/// </summary>
+/// <param name="original_str">The original std::string. Must outlive the returned Partition</param>
+/// <param name="sep">The separator std::string</param>
+/// <returns>
+/// A Partition of StringViews into original_str:
+/// head -> before separator if found
+/// sep -> separator if found
+/// tail -> after separator if found
+/// If the separator is not in the original std::string, head views all of it and the other 2 are empty.
+/// </returns>
+StringFunctions::Partition StringFunctions::rpartition(const std::string &original_str, const std::string &sep)
+{
+	return makePartition(original_str, original_str.rfind(sep), sep.size());
+}
+
+/// <summary>
+/// Splits the original_str by delimiter, interning every token into the given StringPool.
+/// No per-token std::string is created for tokens that are already in the pool.
 /// </summary>
 /// <param name="original_str">The original std::string</param>
-/// <returns>Copy of original_str in Title Case</returns>
-std::string StringFunctions::toTitleCase(const std::string &original_str)
+/// <param name="delim">The delimiter.</param>
+/// <param name="pool">The StringPool to intern tokens into</param>
+/// <returns>std::vector of StringViews of the pooled tokens, one per token, in the same order splitIntoVector() would return them</returns>
+std::vector<StringView> StringFunctions::splitIntoVector(const std::string &original_str, const std::string &delim, StringPool &pool)
 {
-	char last_char = ' ';
-	std::string ret_str = "";
+	std::vector<StringView> ret_vec;
+	size_t step = std::max(delim.size(), static_cast<size_t>(1));
+	size_t pos = 0;
 
-	for (char c : original_str)
+	while (pos < original_str.size())
 	{
-		if (last_char == ' ')
+		size_t loc = original_str.find(delim, pos);
+		// found in string
+		if (loc != std::string::npos)
 		{
-			ret_str += toupper(c);
+			ret_vec.push_back(pool.intern(original_str.data() + pos, loc - pos));
+			pos = loc + step;
 		}
 		else
 		{
-			ret_str += c;
+			ret_vec.push_back(pool.intern(original_str.data() + pos, original_str.size() - pos));
+			break;
 		}
-		last_char = c;
 	}
 
-	return ret_str;
+	return ret_vec;
 }
 
 /// <summary>
-/// Returns a copy of the given string in UPPERCASE
+/// Splits the original_str by whitespace, interning every token into the given StringPool.
 /// </summary>
 /// <param name="original_str">The original std::string</param>
-/// <returns>Copy of original_str in UPPERCASE</returns>
-std::string StringFunctions::toUpperCase(const std::string &original_str)
+/// <param name="pool">The StringPool to intern tokens into</param>
+/// <returns>std::vector of StringViews of the pooled tokens, one per token, in the same order splitIntoVectorByWhitespace() would return them</returns>
+std::vector<StringView> StringFunctions::splitIntoVectorByWhitespace(const std::string &original_str, StringPool &pool)
 {
-	std::string ret_str = "";
+	std::vector<StringView> ret_vec;
+	size_t pos = 0;
 
-	for (char c : original_str)
+	while (pos < original_str.size())
 	{
-		ret_str += toupper(c);
+		size_t loc = original_str.find(' ', pos);
+		if (loc == std::string::npos)
+		{
+			loc = original_str.size();
+		}
+
+		if (loc != pos)
+		{
+			ret_vec.push_back(pool.intern(original_str.data() + pos, loc - pos));
+		}
+		pos = loc + 1;
 	}
 
+	return ret_vec;
+}
+
+/// <summary>
+/// Returns a copy of the given string in Title Case
+/// </summary>
+/// <param name="original_str">The original std::string</param>
+/// <returns>Copy of original_str in Title Case</returns>
+std::string StringFunctions::toTitleCase(const std::string &original_str)
+{
+	std::string ret_str = original_str;
+	StringFunctions::toTitleCaseInPlace(ret_str);
+	return ret_str;
+}
+
+/// <summary>
+/// Returns the given string in Title Case, reusing the given std::string's buffer instead of copying it
+/// </summary>
+/// <param name="original_str">The original std::string. It is moved into the return value</param>
+/// <returns>The same result as the const std::string &amp; overload</returns>
+std::string StringFunctions::toTitleCase(std::string &&original_str)
+{
+	StringFunctions::toTitleCaseInPlace(original_str);
+	return std::move(original_str);
+}
+
+/// <summary>
+/// Returns a copy of the given string in UPPERCASE
+/// </summary>
+/// <param name="original_str">The original std::string</param>
+/// <returns>Copy of original_str in UPPERCASE</returns>
+std::string StringFunctions::toUpperCase(const std::string &original_str)
+{
+	std::string ret_str = original_str;
+	StringFunctions::toUpperCaseInPlace(ret_str);
 	return ret_str;
 }
 
+/// <summary>
+/// Returns the given string in UPPERCASE, reusing the given std::string's buffer instead of copying it
+/// </summary>
+/// <param name="original_str">The original std::string. It is moved into the return value</param>
+/// <returns>The same result as the const std::string &amp; overload</returns>
+std::string StringFunctions::toUpperCase(std::string &&original_str)
+{
+	StringFunctions::toUpperCaseInPlace(original_str);
+	return std::move(original_str);
+}
+
 /// <summary>
 /// Returns a copy of the given string in lowercase
 /// </summary>
@@ -226,14 +410,49 @@ std::string StringFunctions::toUpperCase(const std::string &original_str)
 /// <returns>Copy of original_str in lowercase</returns>
 std::string StringFunctions::toLowerCase(const std::string &original_str)
 {
-	std::string ret_str = "";
+	std::string ret_str = original_str;
+	StringFunctions::toLowerCaseInPlace(ret_str);
+	return ret_str;
+}
 
-	for (char c : original_str)
-	{
-		ret_str += tolower(c);
-	}
+/// <summary>
+/// Returns the given string in lowercase, reusing the given std::string's buffer instead of copying it
+/// </summary>
+/// <param name="original_str">The original std::string. It is moved into the return value</param>
+/// <returns>The same result as the const std::string &amp; overload</returns>
+std::string StringFunctions::toLowerCase(std::string &&original_str)
+{
+	StringFunctions::toLowerCaseInPlace(original_str);
+	return std::move(original_str);
+}
 
-	return ret_str;
+/// <summary>
+/// Interns the UPPERCASE form of the given string into the given StringPool
+/// </summary>
+/// <param name="original_str">The original std::string</param>
+/// <param name="pool">The StringPool to intern into</param>
+/// <returns>StringView of the pooled UPPERCASE string</returns>
+StringView StringFunctions::toUpperCase(const std::string &original_str, StringPool &pool)
+{
+	// Case-map into a per-thread buffer that keeps its capacity, so only new strings allocate (inside the pool)
+	static thread_local std::string buffer;
+	buffer.assign(original_str);
+	StringFunctions::toUpperCaseInPlace(buffer);
+	return pool.intern(buffer.data(), buffer.size());
+}
+
+/// <summary>
+/// Interns the lowercase form of the given string into the given StringPool
+/// </summary>
+/// <param name="original_str">The original std::string</param>
+/// <param name="pool">The StringPool to intern into</param>
+/// <returns>StringView of the pooled lowercase string</returns>
+StringView StringFunctions::toLowerCase(const std::string &original_str, StringPool &pool)
+{
+	static thread_local std::string buffer;
+	buffer.assign(original_str);
+	StringFunctions::toLowerCaseInPlace(buffer);
+	return pool.intern(buffer.data(), buffer.size());
 }
 
 /// <summary>
@@ -243,46 +462,69 @@ std::string StringFunctions::toLowerCase(const std::string &original_str)
 /// <returns>original_str with flipped case</returns>
 std::string StringFunctions::swapCase(const std::string &original_str)
 {
-	std::string ret_str = "";
-
-	for (char c : original_str)
-	{
-		if (islower(c))
-		{
-			ret_str += toupper(c);
-		}
-		else
-		{
-			ret_str += tolower(c);
-		}
-	}
-
+	std::string ret_str = original_str;
+	StringFunctions::swapCaseInPlace(ret_str);
 	return ret_str;
 }
 
 /// <summary>
-/// Slices the specified original_str between x and y using a python-style slice
+/// Returns the given string with all cases flipped, reusing the given std::string's buffer instead of copying it
+/// </summary>
+/// <param name="original_str">The original std::string. It is moved into the return value</param>
+/// <returns>The same result as the const std::string &amp; overload</returns>
+std::string StringFunctions::swapCase(std::string &&original_str)
+{
+	StringFunctions::swapCaseInPlace(original_str);
+	return std::move(original_str);
+}
+
+/// <summary>
+/// Slices the specified original_str between x and y using a python-style slice.
+/// Indexes count bytes; see Utf8Functions::slice() to slice by code point.
 /// </summary>
 /// <param name="original_str">The original_str.</param>
 /// <param name="slice_str">slicing info as string ex: "[1:3]"</param>
 /// <returns>std::string slice from original_str. Returns "" on error</returns>
 std::string StringFunctions::slice(const std::string &original_str, const std::string &slice_str)
+{
+	size_t start = 0;
+	size_t count = 0;
+
+	if (!StringFunctions::resolveSlice(slice_str, original_str.size(), start, count))
+	{
+		return "";
+	}
+
+	return original_str.substr(start, count);
+}
+
+/// <summary>
+/// Resolves a python-style slice string against a sequence of the given length
+/// </summary>
+/// <param name="slice_str">slicing info as string ex: "[1:3]"</param>
+/// <param name="length">Number of items in the sequence being sliced</param>
+/// <param name="start">On success, gets the index of the first item in the slice</param>
+/// <param name="count">On success, gets the number of items in the slice (start + count never exceeds length)</param>
+/// <returns>True on success, False if the slice_str is improper or out of range</returns>
+bool StringFunctions::resolveSlice(const std::string &slice_str, const size_t &length, size_t &start, size_t &count)
 {
 	if (slice_str.size() < 3)
 	{
 		std::cerr << "ERROR: Improper slice string " << slice_str << ". Good Examples: \"[1]\", \"[1:2]\", \"[-1, 5]\", \"[:]\"" << std::endl;
-		return "";
+		return false;
 	}
 
 	if (slice_str.front() != '[' || slice_str.back() != ']')
 	{
 		std::cerr << "ERROR: Improper slice string " << slice_str << ". Should start with \"[\" and end with \"]\"" << std::endl;
-		return "";
+		return false;
 	}
 
 	if (slice_str == "[:]")
 	{
-		return std::string(original_str);
+		start = 0;
+		count = length;
+		return true;
 	}
 
 	std::string working_slice = slice_str;
@@ -295,75 +537,72 @@ std::string StringFunctions::slice(const std::string &original_str, const std::s
 	size_t colon_loc = working_slice.find(":");
 
 
-	// colon not found, try to cast to int
+	// colon not found, try to parse an int
 	// example [1]
 	if (colon_loc == std::string::npos)
 	{
-		int ret_index = std::stoi(working_slice);
-		if (static_cast<unsigned int>(abs(ret_index)) > original_str.size())
+		int64_t ret_index = 0;
+		if (!StringFunctions::parseSliceIndex(working_slice, ret_index))
+		{
+			std::cerr << "ERROR: Improper index " << working_slice << " in slice string " << slice_str << std::endl;
+			return false;
+		}
+
+		if (ret_index > static_cast<int64_t>(length) || ret_index < -static_cast<int64_t>(length))
 		{
 			std::cerr << "ERROR: Index " << ret_index << " is out of range" << std::endl;
-			return "";
+			return false;
 		}
 		else if (ret_index < 0)
 		{
-			ret_index = static_cast<int>(original_str.size() - abs(ret_index));
+			ret_index += static_cast<int64_t>(length);
 		}
 
-		return original_str.substr(ret_index, 1);
+		start = static_cast<size_t>(ret_index);
+		count = std::min(static_cast<size_t>(1), length - start);
+		return true;
 	}
 	else
 	{
-		int l_index = 0;
-		int r_index = 0;
-		try
+		int64_t l_index = 0;
+		int64_t r_index = 0;
+		std::string l_str = working_slice.substr(0, colon_loc);
+		std::string r_str = working_slice.substr(colon_loc + 1);
+
+		//an empty r_index means the end
+		//anything else that does not start with an int is treated as 0
+		if (StringFunctions::isOnlyWhitespace(r_str))
 		{
-			l_index = std::stoi(working_slice.substr(0, colon_loc));
+			r_index = static_cast<int64_t>(length);
 		}
-		catch (const std::invalid_argument &ia)
+		else if (!StringFunctions::parseSliceIndex(r_str, r_index))
 		{
-			ia.what();
-
-			//something wrong with l_index
-			//it might be empty
-			if (StringFunctions::isOnlyWhitespace(working_slice.substr(0, colon_loc)))
-			{
-				l_index = 0;
-			}
+			r_index = 0;
 		}
 
-		try
+		if (!StringFunctions::parseSliceIndex(l_str, l_index))
 		{
-			r_index = std::stoi(working_slice.substr(colon_loc + 1));
-		}
-		catch (const std::invalid_argument &ia)
-		{
-			ia.what();
-
-			//something wrong with r_index
-			//it might be empty
-			if (StringFunctions::isOnlyWhitespace(working_slice.substr(colon_loc + 1)))
-			{
-				r_index = static_cast<int>(original_str.size());
-			}
+			l_index = 0;
 		}
 
 		if (l_index < 0)
 		{
-			l_index = std::max(static_cast<int>(original_str.size() - abs(l_index)), static_cast<int>(0));
+			l_index = std::max(static_cast<int64_t>(length) + l_index, static_cast<int64_t>(0));
 		}
 
 		if (r_index < 0)
 		{
-			r_index = static_cast<int>(original_str.size() - abs(r_index));
+			r_index = static_cast<int64_t>(length) + r_index;
 		}
 
-		if (l_index == r_index || l_index >= r_index || static_cast<unsigned int>(l_index) > original_str.size())
+		if (l_index >= r_index || l_index > static_cast<int64_t>(length))
 		{
-			return "";
+			return false;
 		}
 
-		return original_str.substr(l_index, (r_index - l_index));
+		start = static_cast<size_t>(l_index);
+		count = std::min(static_cast<size_t>(r_index - l_index), length - start);
+		return true;
 	}
 }
 
@@ -375,18 +614,27 @@ std::string StringFunctions::slice(const std::string &original_str, const std::s
 /// <returns>A copy of the original std::string without leading and trailing whitespace</returns>
 std::string StringFunctions::trim(const std::string &original_str, const std::string &removal_chars)
 {
-	std::string working_str = original_str;
-	size_t rtrim_loc = working_str.find_last_not_of(removal_chars) + 1;
-	size_t ltrim_loc = working_str.find_first_not_of(removal_chars);
+	size_t ltrim_loc = original_str.find_first_not_of(removal_chars);
 
 	if (ltrim_loc == std::string::npos)
 	{
 		return "";
 	}
-	else
-	{
-		return working_str.erase(rtrim_loc).substr(ltrim_loc);
-	}
+
+	size_t rtrim_loc = original_str.find_last_not_of(removal_chars) + 1;
+	return original_str.substr(ltrim_loc, rtrim_loc - ltrim_loc);
+}
+
+/// <summary>
+/// Performs a left and right trim on the given string, reusing the given std::string's buffer instead of copying it
+/// </summary>
+/// <param name="original_str">The original std::string. It is moved into the return value</param>
+/// <param name="removal_chars">Chars to be trimmed (Defaults to all whitespace)</param>
+/// <returns>The same result as the const std::string &amp; overload</returns>
+std::string StringFunctions::trim(std::string &&original_str, const std::string &removal_chars)
+{
+	StringFunctions::trimInPlace(original_str, removal_chars);
+	return std::move(original_str);
 }
 
 /// <summary>
@@ -397,8 +645,7 @@ std::string StringFunctions::trim(const std::string &original_str, const std::st
 /// <returns>A copy of the original std::string without leading whitespace</returns>
 std::string StringFunctions::ltrim(const std::string &original_str, const std::string &removal_chars)
 {
-	std::string working_str = original_str;
-	size_t ltrim_loc = working_str.find_first_not_of(removal_chars);
+	size_t ltrim_loc = original_str.find_first_not_of(removal_chars);
 
 	if (ltrim_loc == std::string::npos)
 	{
@@ -406,10 +653,22 @@ std::string StringFunctions::ltrim(const std::string &original_str, const std::s
 	}
 	else
 	{
-		return working_str.substr(ltrim_loc);
+		return original_str.substr(ltrim_loc);
 	}
 }
 
+/// <summary>
+/// Performs a left trim on the given string, reusing the given std::string's buffer instead of copying it
+/// </summary>
+/// <param name="original_str">The original std::string. It is moved into the return value</param>
+/// <param name="removal_chars">Chars to be trimmed (Defaults to all whitespace)</param>
+/// <returns>The same result as the const std::string &amp; overload</returns>
+std::string StringFunctions::ltrim(std::string &&original_str, const std::string &removal_chars)
+{
+	StringFunctions::ltrimInPlace(original_str, removal_chars);
+	return std::move(original_str);
+}
+
 /// <summary>
 /// Performs a right trim on the specified original_str.
 /// </summary>
@@ -418,10 +677,21 @@ std::string StringFunctions::ltrim(const std::string &original_str, const std::s
 /// <returns>A copy of the original std::string without trailing whitespace</returns>
 std::string StringFunctions::rtrim(const std::string &original_str, const std::string &removal_chars)
 {
-	std::string working_str = original_str;
-	size_t rtrim_loc = working_str.find_last_not_of(removal_chars) + 1;
+	size_t rtrim_loc = original_str.find_last_not_of(removal_chars) + 1;
 
-	return working_str.erase(rtrim_loc);
+	return original_str.substr(0, rtrim_loc);
+}
+
+/// <summary>
+/// Performs a right trim on the given string, reusing the given std::string's buffer instead of copying it
+/// </summary>
+/// <param name="original_str">The original std::string. It is moved into the return value</param>
+/// <param name="removal_chars">Chars to be trimmed (Defaults to all whitespace)</param>
+/// <returns>The same result as the const std::string &amp; overload</returns>
+std::string StringFunctions::rtrim(std::string &&original_str, const std::string &removal_chars)
+{
+	StringFunctions::rtrimInPlace(original_str, removal_chars);
+	return std::move(original_str);
 }
 
 /// <summary>
@@ -433,19 +703,22 @@ std::string StringFunctions::rtrim(const std::string &original_str, const std::s
 /// <returns>A std::string of size expected_length or larger if the original std::string was longer</returns>
 std::string StringFunctions::ljust(const std::string &original_str, const unsigned int &expected_length, const char &fill_char)
 {
-	if (original_str.size() > expected_length)
-	{
-		return original_str;
-	}
-
-	std::string working_str = original_str;
-
-	while (working_str.size() != expected_length)
-	{
-		working_str = working_str + fill_char;
-	}
+	std::string ret_str = original_str;
+	StringFunctions::ljustInPlace(ret_str, expected_length, fill_char);
+	return ret_str;
+}
 
-	return working_str;
+/// <summary>
+/// Justifies the given string to the left, reusing the given std::string's buffer instead of copying it
+/// </summary>
+/// <param name="original_str">The original std::string. It is moved into the return value</param>
+/// <param name="expected_length">The length of the return std::string (unless this parameter is less than the original std::string's length</param>
+/// <param name="fill_char">A char to pad the returning std::string with</param>
+/// <returns>The same result as the const std::string &amp; overload</returns>
+std::string StringFunctions::ljust(std::string &&original_str, const unsigned int &expected_length, const char &fill_char)
+{
+	StringFunctions::ljustInPlace(original_str, expected_length, fill_char);
+	return std::move(original_str);
 }
 
 /// <summary>
@@ -457,19 +730,22 @@ std::string StringFunctions::ljust(const std::string &original_str, const unsign
 /// <returns>A std::string of size expected_length or larger if the original std::string was longer</returns>
 std::string StringFunctions::rjust(const std::string &original_str, const unsigned int &expected_length, const char &fill_char)
 {
-	if (original_str.size() > expected_length)
-	{
-		return original_str;
-	}
-
-	std::string working_str = original_str;
-
-	while (working_str.size() != expected_length)
-	{
-		working_str = fill_char + working_str;
-	}
+	std::string ret_str = original_str;
+	StringFunctions::rjustInPlace(ret_str, expected_length, fill_char);
+	return ret_str;
+}
 
-	return working_str;
+/// <summary>
+/// Justifies the given string to the right, reusing the given std::string's buffer instead of copying it
+/// </summary>
+/// <param name="original_str">The original std::string. It is moved into the return value</param>
+/// <param name="expected_length">The length of the return std::string (unless this parameter is less than the original std::string's length</param>
+/// <param name="fill_char">A char to pad the returning std::string with</param>
+/// <returns>The same result as the const std::string &amp; overload</returns>
+std::string StringFunctions::rjust(std::string &&original_str, const unsigned int &expected_length, const char &fill_char)
+{
+	StringFunctions::rjustInPlace(original_str, expected_length, fill_char);
+	return std::move(original_str);
 }
 
 /// <summary>
@@ -502,13 +778,161 @@ std::string StringFunctions::join(const std::string &sep, const std::vector<std:
 /// <returns>A reverse std::string of the original std::string</returns>
 std::string StringFunctions::reverse(const std::string &original_str)
 {
-	std::string working_str = "";
-	for (std::string::const_reverse_iterator itr = original_str.crbegin(); itr != original_str.crend(); itr++)
+	std::string ret_str = original_str;
+	StringFunctions::reverseInPlace(ret_str);
+	return ret_str;
+}
+
+/// <summary>
+/// Reverses the given string, reusing the given std::string's buffer instead of copying it
+/// </summary>
+/// <param name="original_str">The original std::string. It is moved into the return value</param>
+/// <returns>The same result as the const std::string &amp; overload</returns>
+std::string StringFunctions::reverse(std::string &&original_str)
+{
+	StringFunctions::reverseInPlace(original_str);
+	return std::move(original_str);
+}
+
+/// <summary>
+/// Converts the given std::string to Title Case in place
+/// </summary>
+/// <param name="str">The std::string to modify</param>
+void StringFunctions::toTitleCaseInPlace(std::string &str)
+{
+	char last_char = ' ';
+
+	for (char &c : str)
 	{
-		working_str += *itr;
+		char cur_char = c;
+		if (last_char == ' ')
+		{
+			c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+		}
+		last_char = cur_char;
 	}
-	
-	return working_str;
+}
+
+/// <summary>
+/// Converts the given std::string to UPPERCASE in place
+/// </summary>
+/// <param name="str">The std::string to modify</param>
+void StringFunctions::toUpperCaseInPlace(std::string &str)
+{
+	for (char &c : str)
+	{
+		c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+	}
+}
+
+/// <summary>
+/// Converts the given std::string to lowercase in place
+/// </summary>
+/// <param name="str">The std::string to modify</param>
+void StringFunctions::toLowerCaseInPlace(std::string &str)
+{
+	for (char &c : str)
+	{
+		c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+	}
+}
+
+/// <summary>
+/// Flips the case of every char of the given std::string in place
+/// </summary>
+/// <param name="str">The std::string to modify</param>
+void StringFunctions::swapCaseInPlace(std::string &str)
+{
+	for (char &c : str)
+	{
+		unsigned char cur_char = static_cast<unsigned char>(c);
+		if (islower(cur_char))
+		{
+			c = static_cast<char>(toupper(cur_char));
+		}
+		else
+		{
+			c = static_cast<char>(tolower(cur_char));
+		}
+	}
+}
+
+/// <summary>
+/// Performs a left and right trim on the given std::string in place
+/// </summary>
+/// <param name="str">The std::string to modify</param>
+/// <param name="removal_chars">Chars to be trimmed (Defaults to all whitespace)</param>
+void StringFunctions::trimInPlace(std::string &str, const std::string &removal_chars)
+{
+	StringFunctions::rtrimInPlace(str, removal_chars);
+	StringFunctions::ltrimInPlace(str, removal_chars);
+}
+
+/// <summary>
+/// Performs a left trim on the given std::string in place
+/// </summary>
+/// <param name="str">The std::string to modify</param>
+/// <param name="removal_chars">Chars to be trimmed (Defaults to all whitespace)</param>
+void StringFunctions::ltrimInPlace(std::string &str, const std::string &removal_chars)
+{
+	size_t ltrim_loc = str.find_first_not_of(removal_chars);
+
+	if (ltrim_loc == std::string::npos)
+	{
+		str.clear();
+	}
+	else
+	{
+		str.erase(0, ltrim_loc);
+	}
+}
+
+/// <summary>
+/// Performs a right trim on the given std::string in place
+/// </summary>
+/// <param name="str">The std::string to modify</param>
+/// <param name="removal_chars">Chars to be trimmed (Defaults to all whitespace)</param>
+void StringFunctions::rtrimInPlace(std::string &str, const std::string &removal_chars)
+{
+	// npos + 1 wraps to 0, clearing a std::string made only of removal_chars
+	str.erase(str.find_last_not_of(removal_chars) + 1);
+}
+
+/// <summary>
+/// Justifies the given std::string to the left in place by adding fill_char to its right
+/// </summary>
+/// <param name="str">The std::string to modify</param>
+/// <param name="expected_length">The length to pad str to. str is left alone if it is already at least this long</param>
+/// <param name="fill_char">A char to pad (the right of) str with</param>
+void StringFunctions::ljustInPlace(std::string &str, const unsigned int &expected_length, const char &fill_char)
+{
+	if (str.size() < expected_length)
+	{
+		str.append(expected_length - str.size(), fill_char);
+	}
+}
+
+/// <summary>
+/// Justifies the given std::string to the right in place by adding fill_char to its left
+/// </summary>
+/// <param name="str">The std::string to modify</param>
+/// <param name="expected_length">The length to pad str to. str is left alone if it is already at least this long</param>
+/// <param name="fill_char">A char to pad (the left of) str with</param>
+void StringFunctions::rjustInPlace(std::string &str, const unsigned int &expected_length, const char &fill_char)
+{
+	if (str.size() < expected_length)
+	{
+		str.insert(0, expected_length - str.size(), fill_char);
+	}
+}
+
+/// <summary>
+/// Reverses the given std::string in place
+/// </summary>
+/// <param name="str">The std::string to modify</param>
+void StringFunctions::reverseInPlace(std::string &str)
+{
+	std::reverse(str.begin(), str.end());
 }
 
 /// <summary>
@@ -533,16 +957,7 @@ bool StringFunctions::startsWith(const std::string &original_str, const std::str
 	if (original_str.size() < check.size())
 		return false;
 
-	std::string working_str = original_str;
-	std::string working_check = check;
-
-	if (!case_matters)
-	{
-		working_check = StringFunctions::toLowerCase(working_check);
-		working_str = StringFunctions::toLowerCase(working_str);
-	}
-
-	return (strncmp(working_str.c_str(), working_check.c_str(), working_check.size()) == 0);
+	return StringFunctions::equalsAt(original_str, 0, check, case_matters);
 }
 
 /// <summary>
@@ -557,16 +972,87 @@ bool StringFunctions::endsWith(const std::string &original_str, const std::strin
 	if (original_str.size() < check.size())
 		return false;
 
-	std::string working_str = original_str;
-	std::string working_check = check;
+	return StringFunctions::equalsAt(original_str, original_str.size() - check.size(), check, case_matters);
+}
+
+/// <summary>
+/// Builds a Partition of original_str around a separator found at sep_loc
+/// </summary>
+/// <param name="original_str">The original std::string</param>
+/// <param name="sep_loc">Index of the separator in original_str, or std::string::npos if it was not found</param>
+/// <param name="sep_size">Size of the separator</param>
+/// <returns>The Partition</returns>
+StringFunctions::Partition StringFunctions::makePartition(const std::string &original_str, const size_t &sep_loc, const size_t &sep_size)
+{
+	Partition ret;
+	const char *data = original_str.data();
+
+	if (sep_loc == std::string::npos)
+	{
+		ret.head = StringView(data, original_str.size());
+		return ret;
+	}
+
+	ret.head = StringView(data, sep_loc);
+	ret.sep = StringView(data + sep_loc, sep_size);
+	ret.tail = StringView(data + sep_loc + sep_size, original_str.size() - sep_loc - sep_size);
+	return ret;
+}
+
+/// <summary>
+/// Compares check against the chars of original_str starting at offset, without copying either
+/// </summary>
+/// <param name="original_str">The original std::string. Must have at least offset + check.size() chars</param>
+/// <param name="offset">Index in original_str to start comparing at</param>
+/// <param name="check">The std::string to compare</param>
+/// <param name="case_matters">If false, chars are compared after tolower()</param>
+/// <returns>True if the chars match</returns>
+bool StringFunctions::equalsAt(const std::string &original_str, const size_t &offset, const std::string &check, const bool &case_matters)
+{
+	if (case_matters)
+	{
+		return original_str.compare(offset, check.size(), check) == 0;
+	}
+
+	for (size_t i = 0; i < check.size(); i++)
+	{
+		if (tolower(static_cast<unsigned char>(original_str[offset + i])) != tolower(static_cast<unsigned char>(check[i])))
+		{
+			return false;
+		}
+	}
 
-	if (!case_matters)
+	return true;
+}
+
+/// <summary>
+/// Parses the integer at the start of a slice index, the way std::stoi does:
+/// leading whitespace is skipped, and anything after the digits is ignored (so "1x" is 1)
+/// </summary>
+/// <param name="index_str">The index part of a slice string</param>
+/// <param name="index">On success, gets the parsed index</param>
+/// <returns>True if index_str starts with an integer that fits in an int64_t</returns>
+bool StringFunctions::parseSliceIndex(const std::string &index_str, int64_t &index)
+{
+	const char *first = index_str.data();
+	const char *last = first + index_str.size();
+
+	while (first != last && isspace(static_cast<unsigned char>(*first)))
+	{
+		first++;
+	}
+
+	const char *digits_end = first;
+	if (digits_end != last && (*digits_end == '-' || *digits_end == '+'))
+	{
+		digits_end++;
+	}
+	while (digits_end != last && *digits_end >= '0' && *digits_end <= '9')
 	{
-		working_check = StringFunctions::toLowerCase(working_check);
-		working_str = StringFunctions::toLowerCase(working_str);
+		digits_end++;
 	}
 
-	return (strncmp(working_str.c_str() + (working_str.size() - working_check.size()), working_check.c_str(), working_check.size()) == 0);
+	return NumberFunctions::parseInt(first, digits_end, index);
 }
 
 #endif StringFunctions_CPP
\ No newline at end of file
@@ -8,14 +8,23 @@
 #define StringFunctions_H
 
 #include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
+#include "SmallVector.h"
+#include "StringView.h"
+
 #define strip trim
 #define lstrip ltrim
 #define rstrip rtrim
+#define stripInPlace trimInPlace
+#define lstripInPlace ltrimInPlace
+#define rstripInPlace rtrimInPlace
+
+class StringPool;
 
  /// <summary>
  /// Class for functions relating to std::strings
@@ -23,28 +32,80 @@
 class StringFunctions
 {
 public:
+	/// <summary>
+	/// Result of partition() and rpartition(): three StringViews into the partitioned std::string
+	/// </summary>
+	struct Partition
+	{
+		StringView head;
+		StringView sep;
+		StringView tail;
+
+		bool found() const;
+		const StringView &operator[](const size_t &index) const;
+		std::vector<std::string> toVector() const;
+	};
+
 	static std::vector<std::string> splitIntoVector(const std::string &original_str, const std::string &delim);
 	static std::vector<std::string> splitIntoVector(const std::string &original_str, const std::vector<std::string> &delims);
 	static std::vector<std::string> splitIntoVectorByWhitespace(const std::string &original_str);
+	static std::vector<std::string> splitDelimitedRecord(const std::string &record, const char &delim = ',', const char &quote = '"');
 	static std::vector<std::string> partitionIntoVector(const std::string &original_str, const std::string &sep);
 	static std::vector<std::string> rpartitionIntoVector(const std::string &original_str, const std::string &sep);
+	static std::vector<StringView> splitIntoVector(const std::string &original_str, const std::string &delim, StringPool &pool);
+	static SmallVector<StringView, 8> splitIntoViews(const std::string &original_str, const std::string &delim);
+	static SmallVector<StringView, 8> splitIntoViews(std::string &&original_str, const std::string &delim) = delete;
+	static Partition partition(const std::string &original_str, const std::string &sep);
+	static Partition partition(std::string &&original_str, const std::string &sep) = delete;
+	static Partition rpartition(const std::string &original_str, const std::string &sep);
+	static Partition rpartition(std::string &&original_str, const std::string &sep) = delete;
+	static std::vector<StringView> splitIntoVectorByWhitespace(const std::string &original_str, StringPool &pool);
 
 	static std::string toTitleCase(const std::string &original_str);
+	static std::string toTitleCase(std::string &&original_str);
 	static std::string toUpperCase(const std::string &original_str);
+	static std::string toUpperCase(std::string &&original_str);
 	static std::string toLowerCase(const std::string &original_str);
+	static std::string toLowerCase(std::string &&original_str);
+	static StringView toUpperCase(const std::string &original_str, StringPool &pool);
+	static StringView toLowerCase(const std::string &original_str, StringPool &pool);
 	static std::string swapCase(const std::string &original_str);
+	static std::string swapCase(std::string &&original_str);
 	static std::string slice(const std::string &original_str, const std::string &slice_str);
 	static std::string trim(const std::string &original_str, const std::string &removal_chars = "\t\n\v\f\r ");
+	static std::string trim(std::string &&original_str, const std::string &removal_chars = "\t\n\v\f\r ");
 	static std::string ltrim(const std::string &original_str, const std::string &removal_chars = "\t\n\v\f\r ");
+	static std::string ltrim(std::string &&original_str, const std::string &removal_chars = "\t\n\v\f\r ");
 	static std::string rtrim(const std::string &original_str, const std::string &removal_chars = "\t\n\v\f\r ");
+	static std::string rtrim(std::string &&original_str, const std::string &removal_chars = "\t\n\v\f\r ");
 	static std::string ljust(const std::string &original_str, const unsigned int &expected_length, const char &fill_char = ' ');
+	static std::string ljust(std::string &&original_str, const unsigned int &expected_length, const char &fill_char = ' ');
 	static std::string rjust(const std::string &original_str, const unsigned int &expected_length, const char &fill_char = ' ');
+	static std::string rjust(std::string &&original_str, const unsigned int &expected_length, const char &fill_char = ' ');
 	static std::string join(const std::string &sep, const std::vector<std::string> &vec);
 	static std::string reverse(const std::string &original_str);
+	static std::string reverse(std::string &&original_str);
+
+	static void toTitleCaseInPlace(std::string &str);
+	static void toUpperCaseInPlace(std::string &str);
+	static void toLowerCaseInPlace(std::string &str);
+	static void swapCaseInPlace(std::string &str);
+	static void trimInPlace(std::string &str, const std::string &removal_chars = "\t\n\v\f\r ");
+	static void ltrimInPlace(std::string &str, const std::string &removal_chars = "\t\n\v\f\r ");
+	static void rtrimInPlace(std::string &str, const std::string &removal_chars = "\t\n\v\f\r ");
+	static void ljustInPlace(std::string &str, const unsigned int &expected_length, const char &fill_char = ' ');
+	static void rjustInPlace(std::string &str, const unsigned int &expected_length, const char &fill_char = ' ');
+	static void reverseInPlace(std::string &str);
 
+	static bool resolveSlice(const std::string &slice_str, const size_t &length, size_t &start, size_t &count);
 	static bool isOnlyWhitespace(const std::string &original_str);
 	static bool startsWith(const std::string &original_str, const std::string &check, const bool &case_matters = true);
 	static bool endsWith(const std::string &original_str, const std::string &check, const bool &case_matters = true);
+
+private:
+	static Partition makePartition(const std::string &original_str, const size_t &sep_loc, const size_t &sep_size);
+	static bool equalsAt(const std::string &original_str, const size_t &offset, const std::string &check, const bool &case_matters);
+	static bool parseSliceIndex(const std::string &index_str, int64_t &index);
 };
 
 #endif StringFunctions_H
@@ -0,0 +1,229 @@
+/*
+* This is the cpp file for the StringPool class of cPlusPlusPlusLib
+* cPPPLib - A library of functions that should be in the C++ Standard Library
+* (C) - Charles Machalow - MIT License
+*/
+
+#ifndef StringPool_CPP
+#define StringPool_CPP
+
+#include "StringPool.h"
+
+/// <summary>
+/// Creates an empty StringPool
+/// </summary>
+/// <param name="shard_count">Number of independently locked shards (Defaults to 16). A value of 0 is treated as 1</param>
+StringPool::StringPool(const size_t &shard_count) : shards(shard_count == 0 ? 1 : shard_count)
+{
+}
+
+/// <summary>
+/// Interns the given std::string
+/// </summary>
+/// <param name="str">The std::string to intern</param>
+/// <returns>A StringView of the pooled copy of str. It stays valid until clear() is called or the pool is destroyed</returns>
+StringView StringPool::intern(const std::string &str)
+{
+	return intern(str.data(), str.size());
+}
+
+/// <summary>
+/// Interns the given range of chars without first building a std::string from it
+/// </summary>
+/// <param name="data">Pointer to the first char</param>
+/// <param name="size">Number of chars</param>
+/// <returns>A StringView of the pooled copy of the chars. It stays valid until clear() is called or the pool is destroyed</returns>
+StringView StringPool::intern(const char *data, const size_t &size)
+{
+	uint64_t hash = HashFunctions::hash(data, size);
+	Shard &shard = shards[hash % shards.size()];
+
+	std::lock_guard<std::mutex> guard(shard.lock);
+
+	const Entry *existing = findInShard(shard, hash, data, size);
+	if (existing != nullptr)
+	{
+		return StringView(existing->data, existing->size);
+	}
+
+	// Keep the load factor at or below 1/2
+	if ((shard.count + 1) * 2 > shard.table.size())
+	{
+		StringPool::grow(shard);
+	}
+
+	Entry added = { hash, StringPool::store(shard, data, size), size };
+
+	size_t mask = shard.table.size() - 1;
+	size_t slot = StringPool::slotOf(hash, shard.table.size());
+	while (shard.table[slot].data != nullptr)
+	{
+		slot = (slot + 1) & mask;
+	}
+	shard.table[slot] = added;
+	shard.count++;
+
+	return StringView(added.data, added.size);
+}
+
+/// <summary>
+/// Looks up the given std::string without adding it to the pool
+/// </summary>
+/// <param name="str">The std::string to look for</param>
+/// <returns>A StringView of the pooled copy of str, or a StringView with a nullptr data() if str has not been interned</returns>
+StringView StringPool::find(const std::string &str) const
+{
+	uint64_t hash = HashFunctions::hash(str.data(), str.size());
+	const Shard &shard = shards[hash % shards.size()];
+
+	std::lock_guard<std::mutex> guard(shard.lock);
+
+	const Entry *existing = findInShard(shard, hash, str.data(), str.size());
+	if (existing == nullptr)
+	{
+		return StringView();
+	}
+
+	return StringView(existing->data, existing->size);
+}
+
+/// <summary>
+/// Gets the number of distinct strings in the pool
+/// </summary>
+/// <returns>The number of distinct strings in the pool</returns>
+size_t StringPool::size() const
+{
+	size_t total = 0;
+
+	for (const Shard &shard : shards)
+	{
+		std::lock_guard<std::mutex> guard(shard.lock);
+		total += shard.count;
+	}
+
+	return total;
+}
+
+/// <summary>
+/// Removes every string from the pool and frees its chunks.
+/// All StringViews previously returned by intern() are invalidated.
+/// </summary>
+void StringPool::clear()
+{
+	for (Shard &shard : shards)
+	{
+		std::lock_guard<std::mutex> guard(shard.lock);
+		shard.table.clear();
+		shard.chunks.clear();
+		shard.chunk_pos = nullptr;
+		shard.chunk_left = 0;
+		shard.count = 0;
+	}
+}
+
+/// <summary>
+/// Gets the home slot of a hash in a table.
+/// The hash is remixed first: its low bits already picked the shard, so they would all be alike within one.
+/// </summary>
+/// <param name="hash">HashFunctions::hash() of the chars</param>
+/// <param name="table_size">Number of slots in the table. Must be a power of 2</param>
+/// <returns>Index of the first slot to probe</returns>
+size_t StringPool::slotOf(const uint64_t &hash, const size_t &table_size)
+{
+	return static_cast<size_t>((hash * 0x9E3779B97F4A7C15ULL) >> 32) & (table_size - 1);
+}
+
+/// <summary>
+/// Copies chars, plus a null terminator, into the shard's arena. The shard's lock must be held.
+/// </summary>
+/// <param name="shard">The shard to store into</param>
+/// <param name="data">Pointer to the first char</param>
+/// <param name="size">Number of chars</param>
+/// <returns>Pointer to the stored copy, which stays put until the shard is cleared</returns>
+const char *StringPool::store(Shard &shard, const char *data, const size_t &size)
+{
+	size_t needed = size + 1;
+	char *copy;
+
+	if (needed > StringPool::LARGE_STRING_SIZE)
+	{
+		shard.chunks.emplace_back(new char[needed]);
+		copy = shard.chunks.back().get();
+	}
+	else
+	{
+		if (needed > shard.chunk_left)
+		{
+			shard.chunks.emplace_back(new char[StringPool::CHUNK_SIZE]);
+			shard.chunk_pos = shard.chunks.back().get();
+			shard.chunk_left = StringPool::CHUNK_SIZE;
+		}
+		copy = shard.chunk_pos;
+		shard.chunk_pos += needed;
+		shard.chunk_left -= needed;
+	}
+
+	if (size != 0)
+	{
+		memcpy(copy, data, size);
+	}
+	copy[size] = '\0';
+
+	return copy;
+}
+
+/// <summary>
+/// Doubles the shard's table (or creates it) and re-inserts every Entry. The shard's lock must be held.
+/// </summary>
+/// <param name="shard">The shard to grow</param>
+void StringPool::grow(Shard &shard)
+{
+	size_t new_size = shard.table.empty() ? StringPool::INITIAL_TABLE_SIZE : shard.table.size() * 2;
+	std::vector<Entry> new_table(new_size, Entry{ 0, nullptr, 0 });
+	size_t mask = new_size - 1;
+
+	for (const Entry &entry : shard.table)
+	{
+		if (entry.data != nullptr)
+		{
+			size_t slot = StringPool::slotOf(entry.hash, new_size);
+			while (new_table[slot].data != nullptr)
+			{
+				slot = (slot + 1) & mask;
+			}
+			new_table[slot] = entry;
+		}
+	}
+
+	shard.table.swap(new_table);
+}
+
+/// <summary>
+/// Finds an already interned string in the given shard. The shard's lock must be held.
+/// </summary>
+/// <param name="shard">The shard to search</param>
+/// <param name="hash">HashFunctions::hash() of the chars</param>
+/// <param name="data">Pointer to the first char</param>
+/// <param name="size">Number of chars</param>
+/// <returns>A pointer to the string's Entry or nullptr if not found</returns>
+const StringPool::Entry *StringPool::findInShard(const Shard &shard, const uint64_t &hash, const char *data, const size_t &size) const
+{
+	if (shard.table.empty())
+	{
+		return nullptr;
+	}
+
+	size_t mask = shard.table.size() - 1;
+	for (size_t slot = StringPool::slotOf(hash, shard.table.size()); shard.table[slot].data != nullptr; slot = (slot + 1) & mask)
+	{
+		const Entry &candidate = shard.table[slot];
+		if (candidate.hash == hash && candidate.size == size && (size == 0 || memcmp(candidate.data, data, size) == 0))
+		{
+			return &candidate;
+		}
+	}
+
+	return nullptr;
+}
+
+#endif StringPool_CPP
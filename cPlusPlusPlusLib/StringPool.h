@@ -0,0 +1,82 @@
+/*
+* This is the header file for the StringPool class of cPlusPlusPlusLib
+* cPPPLib - A library of functions that should be in the C++ Standard Library
+* (C) - Charles Machalow - MIT License
+*/
+
+#ifndef StringPool_H
+#define StringPool_H
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "HashFunctions.h"
+#include "StringView.h"
+
+/// <summary>
+/// Thread-safe pool of interned strings.
+/// Each distinct string is stored exactly once, and interning returns a StringView of that stable, null terminated copy.
+/// Two interned strings are equal if and only if their data() pointers are equal.
+/// The pool is split into shards, each with its own lock, so many threads can intern at once.
+/// </summary>
+class StringPool
+{
+public:
+	StringPool(const size_t &shard_count = 16);
+
+	StringPool(const StringPool &) = delete;
+	StringPool &operator=(const StringPool &) = delete;
+
+	StringView intern(const std::string &str);
+	StringView intern(const char *data, const size_t &size);
+	StringView find(const std::string &str) const;
+
+	size_t size() const;
+	void clear();
+
+private:
+	// Chars are stored in chunks of this many bytes
+	static const size_t CHUNK_SIZE = 64 * 1024;
+	// Strings bigger than this get a chunk of their own, so they don't waste the rest of the current chunk
+	static const size_t LARGE_STRING_SIZE = CHUNK_SIZE / 8;
+	// Starting number of slots in a shard's table. Must be a power of 2
+	static const size_t INITIAL_TABLE_SIZE = 64;
+
+	/// <summary>
+	/// A slot of a shard's open addressed table. data is nullptr for empty slots.
+	/// </summary>
+	struct Entry
+	{
+		uint64_t hash;
+		const char *data;
+		size_t size;
+	};
+
+	/// <summary>
+	/// A single lock-protected slice of the pool.
+	/// Strings are copied into chunked char arenas, which never move, and found through a linear probing table of Entries.
+	/// </summary>
+	struct Shard
+	{
+		mutable std::mutex lock;
+		std::vector<std::unique_ptr<char[]>> chunks;
+		char *chunk_pos = nullptr;
+		size_t chunk_left = 0;
+		std::vector<Entry> table;
+		size_t count = 0;
+	};
+
+	static size_t slotOf(const uint64_t &hash, const size_t &table_size);
+	static const char *store(Shard &shard, const char *data, const size_t &size);
+	static void grow(Shard &shard);
+
+	const Entry *findInShard(const Shard &shard, const uint64_t &hash, const char *data, const size_t &size) const;
+
+	std::vector<Shard> shards;
+};
+
+#endif StringPool_H
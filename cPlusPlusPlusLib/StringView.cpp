@@ -0,0 +1,89 @@
+/*
+* This is the cpp file for the StringView class of cPlusPlusPlusLib
+* cPPPLib - A library of functions that should be in the C++ Standard Library
+* (C) - Charles Machalow - MIT License
+*/
+
+#ifndef StringView_CPP
+#define StringView_CPP
+
+#include "StringView.h"
+
+#include <algorithm>
+
+const size_t StringView::npos;
+
+/// <summary>
+/// Gets a view of part of this view. Like std::string::substr(), but without copying.
+/// </summary>
+/// <param name="pos">Index of the first char</param>
+/// <param name="count">Max number of chars (Defaults to the rest of the view)</param>
+/// <returns>StringView of the requested range, clamped to this view</returns>
+StringView StringView::substr(const size_t &pos, const size_t &count) const
+{
+	size_t start = std::min(pos, view_size);
+	return StringView(view_data + start, std::min(count, view_size - start));
+}
+
+/// <summary>
+/// Finds the first instance of a char
+/// </summary>
+/// <param name="c">The char to look for</param>
+/// <param name="pos">Index to start looking from (Defaults to 0)</param>
+/// <returns>Index of the char or StringView::npos if it wasn't found</returns>
+size_t StringView::find(const char &c, const size_t &pos) const
+{
+	if (pos >= view_size)
+	{
+		return npos;
+	}
+
+	const void *found = memchr(view_data + pos, c, view_size - pos);
+	if (found == nullptr)
+	{
+		return npos;
+	}
+	return static_cast<const char *>(found) - view_data;
+}
+
+/// <summary>
+/// Copies the viewed chars into a new std::string
+/// </summary>
+/// <returns>std::string holding a copy of the view</returns>
+std::string StringView::str() const
+{
+	return std::string(view_data, view_size);
+}
+
+/// <summary>
+/// Compares the viewed chars of two StringViews
+/// </summary>
+/// <param name="other">The other StringView</param>
+/// <returns>True if both views hold the same chars</returns>
+bool StringView::operator==(const StringView &other) const
+{
+	return view_size == other.view_size && (view_size == 0 || memcmp(view_data, other.view_data, view_size) == 0);
+}
+
+/// <summary>
+/// Compares the viewed chars of two StringViews
+/// </summary>
+/// <param name="other">The other StringView</param>
+/// <returns>True if the views hold different chars</returns>
+bool StringView::operator!=(const StringView &other) const
+{
+	return !(*this == other);
+}
+
+/// <summary>
+/// Writes the viewed chars to a std::ostream
+/// </summary>
+/// <param name="os">The std::ostream to write to</param>
+/// <param name="view">The StringView to write</param>
+/// <returns>os</returns>
+std::ostream &operator<<(std::ostream &os, const StringView &view)
+{
+	return os.write(view.data(), view.size());
+}
+
+#endif StringView_CPP
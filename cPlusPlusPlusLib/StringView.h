@@ -0,0 +1,49 @@
+/*
+* This is the header file for the StringView class of cPlusPlusPlusLib
+* cPPPLib - A library of functions that should be in the C++ Standard Library
+* (C) - Charles Machalow - MIT License
+*/
+
+#ifndef StringView_H
+#define StringView_H
+
+#include <cstring>
+#include <iostream>
+#include <string>
+
+/// <summary>
+/// Non-owning, read-only view of a range of chars (a stand-in for C++17's std::string_view).
+/// The viewed chars must outlive the StringView.
+/// </summary>
+class StringView
+{
+public:
+	static const size_t npos = static_cast<size_t>(-1);
+
+	StringView() : view_data(nullptr), view_size(0) {}
+	StringView(const char *data, const size_t &size) : view_data(data), view_size(size) {}
+	StringView(const char *c_str) : view_data(c_str), view_size(c_str ? strlen(c_str) : 0) {}
+	StringView(const std::string &str) : view_data(str.data()), view_size(str.size()) {}
+
+	const char *data() const { return view_data; }
+	size_t size() const { return view_size; }
+	bool empty() const { return view_size == 0; }
+	const char *begin() const { return view_data; }
+	const char *end() const { return view_data + view_size; }
+	const char &operator[](const size_t &index) const { return view_data[index]; }
+
+	StringView substr(const size_t &pos, const size_t &count = npos) const;
+	size_t find(const char &c, const size_t &pos = 0) const;
+	std::string str() const;
+
+	bool operator==(const StringView &other) const;
+	bool operator!=(const StringView &other) const;
+
+private:
+	const char *view_data;
+	size_t view_size;
+};
+
+std::ostream &operator<<(std::ostream &os, const StringView &view);
+
+#endif StringView_H
@@ -0,0 +1,283 @@
+/*
+* This is the cpp file for the ThreadPool class of cPlusPlusPlusLib
+* cPPPLib - A library of functions that should be in the C++ Standard Library
+* (C) - Charles Machalow - MIT License
+*/
+
+#ifndef ThreadPool_CPP
+#define ThreadPool_CPP
+
+#include "ThreadPool.h"
+#include "UtilityFunctions.h"
+
+#include <cerrno>
+
+#ifdef __linux
+#include <pthread.h>
+#include <sched.h>
+#endif //__linux
+
+// The pool (if any) the current thread is a worker of, and its index in that pool
+static thread_local ThreadPool *current_pool = nullptr;
+static thread_local size_t current_index = 0;
+
+/// <summary>
+/// Settings used when ThreadPool::shared() is first created, and whether that has happened
+/// </summary>
+struct SharedPoolSettings
+{
+	size_t thread_count;
+	bool pin_threads;
+	bool created;
+};
+
+// configureShared() and the creation of the shared pool both hold this, so a configuration either lands first or fails
+static std::mutex shared_lock;
+static SharedPoolSettings shared_settings = { 0, false, false };
+
+/// <summary>
+/// Marks the shared ThreadPool as created and gets the settings to build it with
+/// </summary>
+/// <returns>The settings given to configureShared(), if any</returns>
+static SharedPoolSettings claimSharedSettings()
+{
+	std::lock_guard<std::mutex> guard(shared_lock);
+	shared_settings.created = true;
+	return shared_settings;
+}
+
+/// <summary>
+/// Creates a ThreadPool and starts its workers
+/// </summary>
+/// <param name="thread_count">Number of worker threads. 0 (default) uses std::thread::hardware_concurrency()</param>
+/// <param name="pin_threads">If true, worker i is pinned to logical CPU (i % number of CPUs) (Defaults to false)</param>
+ThreadPool::ThreadPool(const size_t &thread_count, const bool &pin_threads) : pending(0), next_queue(0), stopping(false), pin(pin_threads)
+{
+	size_t count = thread_count;
+	if (count == 0)
+	{
+		count = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		queues.emplace_back(new WorkerQueue());
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		threads.emplace_back(&ThreadPool::workerLoop, this, i);
+	}
+}
+
+/// <summary>
+/// Runs every task still queued, then stops and joins the workers
+/// </summary>
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> guard(wake_lock);
+		stopping = true;
+	}
+	wake.notify_all();
+
+	for (std::thread &thread : threads)
+	{
+		thread.join();
+	}
+}
+
+/// <summary>
+/// Gets the number of worker threads
+/// </summary>
+/// <returns>The number of worker threads</returns>
+size_t ThreadPool::size() const
+{
+	return threads.size();
+}
+
+/// <summary>
+/// Gets the process-wide ThreadPool used by the library's parallel algorithms.
+/// It is created on first use with the settings given to configureShared().
+/// </summary>
+/// <returns>Reference to the shared ThreadPool</returns>
+ThreadPool &ThreadPool::shared()
+{
+	// Function local statics are initialized once, so only the first call takes the lock
+	static const SharedPoolSettings settings = claimSharedSettings();
+	static ThreadPool pool(settings.thread_count, settings.pin_threads);
+	return pool;
+}
+
+/// <summary>
+/// Sets how the shared ThreadPool will be built. Only has an effect before the first call to shared().
+/// </summary>
+/// <param name="thread_count">Number of worker threads. 0 uses std::thread::hardware_concurrency()</param>
+/// <param name="pin_threads">If true, pin each worker to a logical CPU (Defaults to false)</param>
+/// <returns>True if the settings will be used, False if the shared ThreadPool already exists</returns>
+bool ThreadPool::configureShared(const size_t &thread_count, const bool &pin_threads)
+{
+	std::lock_guard<std::mutex> guard(shared_lock);
+
+	if (shared_settings.created)
+	{
+		return false;
+	}
+
+	shared_settings.thread_count = thread_count;
+	shared_settings.pin_threads = pin_threads;
+	return true;
+}
+
+/// <summary>
+/// Queues a task. Tasks queued from a worker of this pool go to that worker's own deque, others are spread round-robin.
+/// </summary>
+/// <param name="task">The task to queue</param>
+void ThreadPool::enqueue(std::function<void()> task)
+{
+	size_t index = current_pool == this ? current_index : next_queue.fetch_add(1) % queues.size();
+
+	// Count the task before it becomes visible so pending never drops below zero
+	{
+		std::lock_guard<std::mutex> guard(wake_lock);
+		pending++;
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(queues[index]->lock);
+		queues[index]->tasks.push_back(std::move(task));
+	}
+	wake.notify_one();
+}
+
+/// <summary>
+/// Runs one queued task if there is one: the newest in the preferred deque, otherwise the oldest stolen from another deque
+/// </summary>
+/// <param name="preferred">Index of the deque to look in first</param>
+/// <returns>True if a task was run</returns>
+bool ThreadPool::tryRunOne(const size_t &preferred)
+{
+	std::function<void()> task;
+
+	for (size_t offset = 0; offset < queues.size() && !task; offset++)
+	{
+		WorkerQueue &queue = *queues[(preferred + offset) % queues.size()];
+		std::lock_guard<std::mutex> guard(queue.lock);
+
+		if (queue.tasks.empty())
+		{
+			continue;
+		}
+
+		if (offset == 0)
+		{
+			task = std::move(queue.tasks.back());
+			queue.tasks.pop_back();
+		}
+		else
+		{
+			task = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+		}
+	}
+
+	if (!task)
+	{
+		return false;
+	}
+
+	pending--;
+	task();
+	return true;
+}
+
+/// <summary>
+/// Waits for every piece of a parallelForRange() call to finish.
+/// A worker of this pool runs other queued tasks meanwhile, so it never blocks the pool it is part of.
+/// Other threads just wait: their own run() has already claimed every piece, so running someone else's task would only add to their latency.
+/// </summary>
+/// <param name="state">The parallelForRange() bookkeeping</param>
+void ThreadPool::waitFor(ParallelForState &state)
+{
+	bool is_worker = current_pool == this;
+
+	while (state.done < state.pieces)
+	{
+		if (is_worker && tryRunOne(current_index))
+		{
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(state.lock);
+		state.finished.wait(lock, [&state]()
+		{
+			return state.done >= state.pieces;
+		});
+	}
+}
+
+/// <summary>
+/// Body of each worker thread: run tasks until the pool is stopping and nothing is left
+/// </summary>
+/// <param name="index">This worker's index</param>
+void ThreadPool::workerLoop(const size_t &index)
+{
+	current_pool = this;
+	current_index = index;
+
+	if (pin)
+	{
+		pinCurrentThread(index);
+	}
+
+	for (;;)
+	{
+		if (tryRunOne(index))
+		{
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(wake_lock);
+		wake.wait(lock, [this]()
+		{
+			return stopping || pending > 0;
+		});
+
+		if (stopping && pending == 0)
+		{
+			return;
+		}
+	}
+}
+
+/// <summary>
+/// Pins the calling thread to a single logical CPU.
+/// Windows: Uses SetThreadAffinityMask() (first 64 CPUs only)
+/// Linux: Uses pthread_setaffinity_np()
+/// </summary>
+/// <param name="index">Worker index. The CPU used is index % number of CPUs</param>
+void ThreadPool::pinCurrentThread(const size_t &index)
+{
+	size_t cpu = index % std::max(std::thread::hardware_concurrency(), 1u);
+
+#ifdef _WIN32
+	if (SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << (cpu % (sizeof(DWORD_PTR) * 8))) == 0)
+	{
+		UtilityFunctions::cperror("SetThreadAffinityMask() failed", false);
+	}
+#endif //_WIN32
+#ifdef __linux
+	cpu_set_t cpu_set;
+	CPU_ZERO(&cpu_set);
+	CPU_SET(cpu, &cpu_set);
+
+	int result = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+	if (result != 0)
+	{
+		errno = result;
+		perror("pthread_setaffinity_np() failed");
+	}
+#endif //__linux
+}
+
+#endif ThreadPool_CPP
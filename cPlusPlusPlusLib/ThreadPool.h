@@ -0,0 +1,260 @@
+/*
+* This is the header file for the ThreadPool class of cPlusPlusPlusLib
+* cPPPLib - A library of functions that should be in the C++ Standard Library
+* (C) - Charles Machalow - MIT License
+*/
+
+#ifndef ThreadPool_H
+#define ThreadPool_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// <summary>
+/// Work-stealing thread pool.
+/// Every worker owns a deque of tasks: it runs its own newest task first, and when empty steals the oldest task from another worker.
+/// Library algorithms share ThreadPool::shared() rather than spawning threads per call.
+/// </summary>
+class ThreadPool
+{
+public:
+	ThreadPool(const size_t &thread_count = 0, const bool &pin_threads = false);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool &operator=(const ThreadPool &) = delete;
+
+	size_t size() const;
+
+	static ThreadPool &shared();
+	static bool configureShared(const size_t &thread_count, const bool &pin_threads = false);
+
+	/// <summary>
+	/// Queues func to run on the pool
+	/// </summary>
+	/// <param name="func">Callable taking no arguments</param>
+	/// <returns>std::future for func's result (or the exception it threw)</returns>
+	template <typename F> auto submit(F func) -> std::future<decltype(func())>
+	{
+		typedef decltype(func()) R;
+
+		std::shared_ptr<std::packaged_task<R()>> task = std::make_shared<std::packaged_task<R()>>(std::move(func));
+		std::future<R> ret_future = task->get_future();
+
+		enqueue([task]()
+		{
+			(*task)();
+		});
+
+		return ret_future;
+	}
+
+	/// <summary>
+	/// Queues func to run on the pool, then queues continuation with func's result once func finishes.
+	/// No thread blocks waiting between the two.
+	/// </summary>
+	/// <param name="func">Callable taking no arguments and returning a non-void value</param>
+	/// <param name="continuation">Callable taking func's result</param>
+	/// <returns>std::future for continuation's result (or the exception thrown by either callable)</returns>
+	template <typename F, typename C> auto submitThen(F func, C continuation) -> std::future<decltype(continuation(func()))>
+	{
+		typedef decltype(func()) R1;
+		typedef decltype(continuation(func())) R2;
+		static_assert(!std::is_void<R1>::value, "ThreadPool::submitThen needs func to return a value to pass on");
+
+		std::shared_ptr<std::promise<R2>> promise = std::make_shared<std::promise<R2>>();
+		std::future<R2> ret_future = promise->get_future();
+
+		enqueue([this, func, continuation, promise]() mutable
+		{
+			try
+			{
+				std::shared_ptr<R1> result = std::make_shared<R1>(func());
+				enqueue([continuation, promise, result]() mutable
+				{
+					try
+					{
+						fulfill(*promise, continuation, std::move(*result));
+					}
+					catch (...)
+					{
+						promise->set_exception(std::current_exception());
+					}
+				});
+			}
+			catch (...)
+			{
+				promise->set_exception(std::current_exception());
+			}
+		});
+
+		return ret_future;
+	}
+
+	/// <summary>
+	/// Calls func(i) for every i in [begin, end) across the pool. Returns once all calls are done.
+	/// The calling thread takes part, so this is safe to call from inside a pool task.
+	/// </summary>
+	/// <param name="begin">First index</param>
+	/// <param name="end">One past the last index</param>
+	/// <param name="func">Callable taking a size_t index. Must be safe to call from several threads at once</param>
+	/// <param name="grain">Indexes handed out per claim. 0 (default) picks one from the range size and pool size</param>
+	template <typename F> void parallelFor(const size_t &begin, const size_t &end, F func, const size_t &grain = 0)
+	{
+		parallelForRange(begin, end, [&func](const size_t &range_begin, const size_t &range_end)
+		{
+			for (size_t i = range_begin; i < range_end; i++)
+			{
+				func(i);
+			}
+		}, grain);
+	}
+
+	/// <summary>
+	/// Calls func(range_begin, range_end) over grain-sized pieces of [begin, end) across the pool. Returns once all calls are done.
+	/// Pieces are claimed dynamically, so uneven pieces balance out. The first exception thrown by func is rethrown here.
+	/// </summary>
+	/// <param name="begin">First index</param>
+	/// <param name="end">One past the last index</param>
+	/// <param name="func">Callable taking (range_begin, range_end). Must be safe to call from several threads at once</param>
+	/// <param name="grain">Indexes per piece. 0 (default) aims for about 8 pieces per worker</param>
+	template <typename F> void parallelForRange(const size_t &begin, const size_t &end, F func, const size_t &grain = 0)
+	{
+		if (end <= begin)
+		{
+			return;
+		}
+
+		size_t count = end - begin;
+		size_t piece = grain != 0 ? grain : std::max(count / (size() * 8), static_cast<size_t>(1));
+		size_t pieces = (count + piece - 1) / piece;
+
+		if (pieces == 1)
+		{
+			func(begin, end);
+			return;
+		}
+
+		std::shared_ptr<ParallelForState> state = std::make_shared<ParallelForState>(pieces);
+		size_t first = begin;
+		size_t last = end;
+
+		// Helpers may start after every piece is claimed; they then exit without touching func
+		std::function<void()> run = [state, &func, first, last, piece]()
+		{
+			for (;;)
+			{
+				size_t cur = state->next.fetch_add(1);
+				if (cur >= state->pieces)
+				{
+					return;
+				}
+
+				try
+				{
+					func(first + cur * piece, std::min(last, first + (cur + 1) * piece));
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> guard(state->lock);
+					if (!state->error)
+					{
+						state->error = std::current_exception();
+					}
+				}
+
+				if (state->done.fetch_add(1) + 1 == state->pieces)
+				{
+					std::lock_guard<std::mutex> guard(state->lock);
+					state->finished.notify_all();
+				}
+			}
+		};
+
+		size_t helpers = std::min(size(), pieces - 1);
+		for (size_t i = 0; i < helpers; i++)
+		{
+			enqueue(run);
+		}
+
+		run();
+		waitFor(*state);
+
+		if (state->error)
+		{
+			std::rethrow_exception(state->error);
+		}
+	}
+
+private:
+	/// <summary>
+	/// Bookkeeping shared between the caller of parallelForRange() and its helper tasks
+	/// </summary>
+	struct ParallelForState
+	{
+		ParallelForState(const size_t &piece_count) : pieces(piece_count), next(0), done(0)
+		{
+		}
+
+		const size_t pieces;
+		std::atomic<size_t> next;
+		std::atomic<size_t> done;
+		std::mutex lock;
+		std::condition_variable finished;
+		std::exception_ptr error;
+	};
+
+	/// <summary>
+	/// A worker's own task deque. The owner uses the back, thieves take from the front.
+	/// </summary>
+	struct WorkerQueue
+	{
+		std::mutex lock;
+		std::deque<std::function<void()>> tasks;
+	};
+
+	/// <summary>
+	/// Sets the promise from continuation(arg)
+	/// </summary>
+	template <typename R, typename C, typename A> static void fulfill(std::promise<R> &promise, C &continuation, A &&arg)
+	{
+		promise.set_value(continuation(std::forward<A>(arg)));
+	}
+
+	/// <summary>
+	/// Sets the void promise after calling continuation(arg)
+	/// </summary>
+	template <typename C, typename A> static void fulfill(std::promise<void> &promise, C &continuation, A &&arg)
+	{
+		continuation(std::forward<A>(arg));
+		promise.set_value();
+	}
+
+	void enqueue(std::function<void()> task);
+	bool tryRunOne(const size_t &preferred);
+	void waitFor(ParallelForState &state);
+	void workerLoop(const size_t &index);
+	static void pinCurrentThread(const size_t &index);
+
+	std::vector<std::unique_ptr<WorkerQueue>> queues;
+	std::vector<std::thread> threads;
+	std::mutex wake_lock;
+	std::condition_variable wake;
+	std::atomic<size_t> pending;
+	std::atomic<size_t> next_queue;
+	std::atomic<bool> stopping;
+	bool pin;
+};
+
+#endif ThreadPool_H
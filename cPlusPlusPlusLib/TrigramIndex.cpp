@@ -0,0 +1,460 @@
+/*
+* This is the cpp file for the TrigramIndex class of cPlusPlusPlusLib
+* cPPPLib - A library of functions that should be in the C++ Standard Library
+* (C) - Charles Machalow - MIT License
+*/
+
+#ifndef TrigramIndex_CPP
+#define TrigramIndex_CPP
+
+#include "TrigramIndex.h"
+
+#include <algorithm>
+#include <mutex>
+
+/// <summary>
+/// Orders Matches by distance, then by index
+/// </summary>
+/// <param name="other">The Match to compare with</param>
+/// <returns>True if this Match comes first</returns>
+bool TrigramIndex::Match::operator<(const Match &other) const
+{
+	if (distance != other.distance)
+	{
+		return distance < other.distance;
+	}
+	return index < other.index;
+}
+
+/// <summary>
+/// Builds the index over the given dictionary. Building uses a 64MB table of trigram counts, freed once it is done.
+/// </summary>
+/// <param name="dictionary">The words to index. Must outlive the index and not change while it is in use</param>
+TrigramIndex::TrigramIndex(const std::vector<std::string> &dictionary) : dictionary(dictionary)
+{
+	std::vector<uint32_t> word_keys;
+
+	// Count the words holding each trigram
+	std::vector<uint32_t> key_slots(KEY_SPACE, 0);
+	size_t longest = 0;
+	for (const std::string &word : dictionary)
+	{
+		trigramsOf(word, word_keys);
+		for (const uint32_t &key : word_keys)
+		{
+			key_slots[key]++;
+		}
+		longest = std::max(longest, word.size());
+	}
+
+	// Lay out one posting list per trigram that occurs, and turn the counts into indexes of those lists
+	uint64_t total = 0;
+	for (size_t key = 0; key < KEY_SPACE; key++)
+	{
+		if (key_slots[key] != 0)
+		{
+			uint32_t count = key_slots[key];
+			key_slots[key] = static_cast<uint32_t>(keys.size());
+			keys.push_back(static_cast<uint32_t>(key));
+			key_offsets.push_back(total);
+			total += count;
+		}
+	}
+	key_offsets.push_back(total);
+
+	// Words are added in order, so every posting list comes out sorted
+	std::vector<uint64_t> fill(key_offsets.begin(), key_offsets.end() - 1);
+	postings.resize(total);
+	for (size_t i = 0; i < dictionary.size(); i++)
+	{
+		trigramsOf(dictionary[i], word_keys);
+		for (const uint32_t &key : word_keys)
+		{
+			postings[fill[key_slots[key]]++] = static_cast<uint32_t>(i);
+		}
+	}
+
+	// Group the words by size for queries too short for the trigram filter
+	size_offsets.assign(longest + 2, 0);
+	word_sizes.reserve(dictionary.size());
+	for (const std::string &word : dictionary)
+	{
+		size_offsets[word.size() + 1]++;
+		word_sizes.push_back(static_cast<uint8_t>(std::min(word.size(), static_cast<size_t>(LONG_WORD))));
+	}
+	for (size_t i = 1; i < size_offsets.size(); i++)
+	{
+		size_offsets[i] += size_offsets[i - 1];
+	}
+
+	fill.assign(size_offsets.begin(), size_offsets.end() - 1);
+	words_by_size.resize(dictionary.size());
+	for (size_t i = 0; i < dictionary.size(); i++)
+	{
+		words_by_size[fill[dictionary[i].size()]++] = static_cast<uint32_t>(i);
+	}
+}
+
+/// <summary>
+/// Finds the k dictionary words closest to query, by Levenshtein distance.
+/// Looks for exact matches first and only widens the search (up to max_distance) while fewer than k words have been found.
+/// </summary>
+/// <param name="query">The string to look up</param>
+/// <param name="k">The most matches to return</param>
+/// <param name="max_distance">The largest distance a match may have</param>
+/// <returns>Up to k Matches, closest first (ties go to the lower index)</returns>
+std::vector<TrigramIndex::Match> TrigramIndex::topK(const StringView &query, const size_t &k, const size_t &max_distance) const
+{
+	std::vector<Match> matches;
+	if (k == 0)
+	{
+		return matches;
+	}
+
+	// Each wider search finds everything the narrower ones did, so it starts over
+	for (size_t distance = 0; distance <= max_distance; distance++)
+	{
+		matches.clear();
+		lookup(query, distance, k, matches);
+		if (matches.size() >= k)
+		{
+			break;
+		}
+	}
+
+	std::sort(matches.begin(), matches.end());
+	return matches;
+}
+
+/// <summary>
+/// Finds every dictionary word within max_distance edits of query
+/// </summary>
+/// <param name="query">The string to look up</param>
+/// <param name="max_distance">The largest distance a match may have</param>
+/// <returns>The Matches, closest first (ties go to the lower index)</returns>
+std::vector<TrigramIndex::Match> TrigramIndex::withinDistance(const StringView &query, const size_t &max_distance) const
+{
+	std::vector<Match> matches;
+	lookup(query, max_distance, StringView::npos, matches);
+	std::sort(matches.begin(), matches.end());
+	return matches;
+}
+
+/// <summary>
+/// Gets the dictionary words that pass the trigram and size filters for query, without checking their distance.
+/// Every word within max_distance of query is included.
+/// </summary>
+/// <param name="query">The string to look up</param>
+/// <param name="max_distance">The largest distance of interest</param>
+/// <returns>Sorted indexes of the candidate words</returns>
+std::vector<size_t> TrigramIndex::candidates(const StringView &query, const size_t &max_distance) const
+{
+	std::vector<uint32_t> indexes;
+	candidateIndexes(query, max_distance, indexes);
+	std::sort(indexes.begin(), indexes.end());
+	return std::vector<size_t>(indexes.begin(), indexes.end());
+}
+
+/// <summary>
+/// Gets the number of words in the dictionary
+/// </summary>
+/// <returns>The number of words</returns>
+size_t TrigramIndex::size() const
+{
+	return dictionary.size();
+}
+
+/// <summary>
+/// Gets the distinct trigrams of a word, padded as described by PAD
+/// </summary>
+/// <param name="word">The word</param>
+/// <param name="keys">Cleared, then set to the sorted trigram keys</param>
+void TrigramIndex::trigramsOf(const StringView &word, std::vector<uint32_t> &keys)
+{
+	keys.clear();
+
+	uint32_t key = (static_cast<uint32_t>(static_cast<unsigned char>(PAD)) << 8) | static_cast<unsigned char>(PAD);
+	for (size_t i = 0; i <= word.size(); i++)
+	{
+		unsigned char c = i < word.size() ? static_cast<unsigned char>(word[i]) : static_cast<unsigned char>(PAD);
+		key = ((key << 8) | c) & (KEY_SPACE - 1);
+		keys.push_back(key);
+	}
+
+	std::sort(keys.begin(), keys.end());
+	keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+}
+
+/// <summary>
+/// Moves a posting list cursor forward to the first word index not below index, galloping ahead then binary searching
+/// </summary>
+/// <param name="cursor">Cursor into a posting list. Moved forward</param>
+/// <param name="end">End of the posting list</param>
+/// <param name="index">The word index to look for</param>
+/// <returns>True if the list holds index</returns>
+bool TrigramIndex::skipTo(const uint32_t *&cursor, const uint32_t *end, const uint32_t &index)
+{
+	size_t step = 1;
+	while (static_cast<size_t>(end - cursor) > step && cursor[step] < index)
+	{
+		step *= 2;
+	}
+
+	cursor = std::lower_bound(cursor, cursor + std::min(step + 1, static_cast<size_t>(end - cursor)), index);
+	return cursor != end && *cursor == index;
+}
+
+/// <summary>
+/// Finds the (up to) k dictionary words closest to query within max_distance
+/// </summary>
+/// <param name="query">The string to look up</param>
+/// <param name="max_distance">The largest distance a match may have</param>
+/// <param name="k">The most matches to keep (StringView::npos for all)</param>
+/// <param name="matches">Empty. Set to the matches, in max heap order</param>
+void TrigramIndex::lookup(const StringView &query, const size_t &max_distance, const size_t &k, std::vector<Match> &matches) const
+{
+	std::vector<uint32_t> indexes;
+	candidateIndexes(query, max_distance, indexes);
+
+	SimilarityFunctions::Pattern pattern(query);
+
+	if (indexes.size() < PARALLEL_CHECK_SIZE)
+	{
+		checkRange(pattern, indexes, 0, indexes.size(), max_distance, k, matches);
+		return;
+	}
+
+	// Each piece keeps its own best k, then they are merged
+	std::mutex lock;
+	ThreadPool::shared().parallelForRange(0, indexes.size(), [this, &pattern, &indexes, &max_distance, &k, &matches, &lock](const size_t &begin, const size_t &end)
+	{
+		std::vector<Match> piece_matches;
+		checkRange(pattern, indexes, begin, end, max_distance, k, piece_matches);
+
+		std::lock_guard<std::mutex> guard(lock);
+		for (const Match &match : piece_matches)
+		{
+			addMatch(match, k, matches);
+		}
+	}, PARALLEL_CHECK_SIZE / 4);
+}
+
+/// <summary>
+/// Checks the distance to candidates indexes[begin, end), keeping the (up to) k closest within max_distance
+/// </summary>
+/// <param name="pattern">The query, prepared</param>
+/// <param name="indexes">Candidate word indexes</param>
+/// <param name="begin">First position in indexes to check</param>
+/// <param name="end">One past the last position in indexes to check</param>
+/// <param name="max_distance">The largest distance a match may have</param>
+/// <param name="k">The most matches to keep (StringView::npos for all)</param>
+/// <param name="matches">Matches kept so far, in max heap order. Added to</param>
+void TrigramIndex::checkRange(const SimilarityFunctions::Pattern &pattern, const std::vector<uint32_t> &indexes, const size_t &begin, const size_t &end, const size_t &max_distance, const size_t &k, std::vector<Match> &matches) const
+{
+	StringView texts[CHECK_BATCH_SIZE];
+	size_t distances[CHECK_BATCH_SIZE];
+	size_t bound = max_distance;
+
+	for (size_t start = begin; start < end; start += CHECK_BATCH_SIZE)
+	{
+		size_t count = std::min(static_cast<size_t>(CHECK_BATCH_SIZE), end - start);
+		for (size_t i = 0; i < count; i++)
+		{
+			texts[i] = dictionary[indexes[start + i]];
+		}
+		pattern.distances(texts, count, bound, distances);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			if (distances[i] > bound)
+			{
+				continue;
+			}
+
+			Match match;
+			match.index = indexes[start + i];
+			match.distance = distances[i];
+			addMatch(match, k, matches);
+
+			// Once k are kept, nothing further than the worst of them can get in
+			if (matches.size() == k)
+			{
+				bound = matches.front().distance;
+			}
+		}
+	}
+}
+
+/// <summary>
+/// Adds a match to a max heap of the (up to) k best matches
+/// </summary>
+/// <param name="match">The match</param>
+/// <param name="k">The most matches to keep</param>
+/// <param name="matches">The heap. The worst match is dropped if it grows past k</param>
+void TrigramIndex::addMatch(const Match &match, const size_t &k, std::vector<Match> &matches)
+{
+	if (matches.size() < k)
+	{
+		matches.push_back(match);
+		std::push_heap(matches.begin(), matches.end());
+	}
+	else if (match < matches.front())
+	{
+		std::pop_heap(matches.begin(), matches.end());
+		matches.back() = match;
+		std::push_heap(matches.begin(), matches.end());
+	}
+}
+
+/// <summary>
+/// Gets the dictionary words that pass the trigram and size filters for query.
+/// A word within max_distance shares at least (query trigrams - 3 * max_distance) trigrams with query, so it must be in
+/// at least one of the 3 * max_distance + 1 shortest of the query's posting lists. Those lists are merged to find the
+/// candidates, then each candidate is looked for in the other lists until it has enough trigrams or cannot get enough.
+/// </summary>
+/// <param name="query">The string to look up</param>
+/// <param name="max_distance">The largest distance of interest</param>
+/// <param name="out">Cleared, then set to the candidate word indexes</param>
+void TrigramIndex::candidateIndexes(const StringView &query, const size_t &max_distance, std::vector<uint32_t> &out) const
+{
+	out.clear();
+
+	std::vector<uint32_t> query_keys;
+	trigramsOf(query, query_keys);
+
+	// Too few trigrams to rule anything out; fall back to the words of a close enough size
+	if (query_keys.size() <= 3 * max_distance)
+	{
+		wordsBySize(query.size(), max_distance, out);
+		return;
+	}
+
+	std::vector<PostingList> lists;
+	for (const uint32_t &key : query_keys)
+	{
+		lists.push_back(postingList(key));
+	}
+	std::sort(lists.begin(), lists.end(), [](const PostingList &a, const PostingList &b)
+	{
+		return a.end - a.begin < b.end - b.begin;
+	});
+
+	const size_t needed = query_keys.size() - 3 * max_distance;
+	const size_t merged = 3 * max_distance + 1;
+	std::vector<const uint32_t *> cursors;
+	for (size_t i = 0; i < lists.size(); i++)
+	{
+		cursors.push_back(lists[i].begin);
+	}
+
+	for (;;)
+	{
+		// Take the lowest word index left in the merged lists, with the number of those lists holding it
+		uint32_t index = UINT32_MAX;
+		bool any = false;
+		for (size_t i = 0; i < merged; i++)
+		{
+			if (cursors[i] != lists[i].end && (!any || *cursors[i] < index))
+			{
+				index = *cursors[i];
+				any = true;
+			}
+		}
+
+		if (!any)
+		{
+			break;
+		}
+
+		size_t found = 0;
+		for (size_t i = 0; i < merged; i++)
+		{
+			if (cursors[i] != lists[i].end && *cursors[i] == index)
+			{
+				cursors[i]++;
+				found++;
+			}
+		}
+
+		if (!sizeWithin(index, query.size(), max_distance))
+		{
+			continue;
+		}
+
+		// Candidates come in increasing order, so the other lists are only ever walked forward
+		for (size_t i = merged; i < lists.size() && found < needed && found + (lists.size() - i) >= needed; i++)
+		{
+			if (skipTo(cursors[i], lists[i].end, index))
+			{
+				found++;
+			}
+		}
+
+		if (found >= needed)
+		{
+			out.push_back(index);
+		}
+	}
+}
+
+/// <summary>
+/// Gets every dictionary word whose size is within max_distance of query_size
+/// </summary>
+/// <param name="query_size">Size of the query</param>
+/// <param name="max_distance">The largest size difference</param>
+/// <param name="out">Appended to with the word indexes</param>
+void TrigramIndex::wordsBySize(const size_t &query_size, const size_t &max_distance, std::vector<uint32_t> &out) const
+{
+	size_t longest = size_offsets.size() - 2;
+	size_t smallest = query_size > max_distance ? query_size - max_distance : 0;
+	size_t largest = std::min(longest, query_size + std::min(max_distance, longest));
+
+	if (smallest > largest)
+	{
+		return;
+	}
+
+	out.insert(out.end(), words_by_size.begin() + size_offsets[smallest], words_by_size.begin() + size_offsets[largest + 1]);
+}
+
+/// <summary>
+/// Checks if a word's size is within max_distance of the query's
+/// </summary>
+/// <param name="index">The word index</param>
+/// <param name="query_size">Size of the query</param>
+/// <param name="max_distance">The largest size difference</param>
+/// <returns>True if the sizes are close enough</returns>
+bool TrigramIndex::sizeWithin(const uint32_t &index, const size_t &query_size, const size_t &max_distance) const
+{
+	size_t word_size = word_sizes[index];
+	if (word_size == LONG_WORD)
+	{
+		word_size = dictionary[index].size();
+	}
+
+	return (word_size > query_size ? word_size - query_size : query_size - word_size) <= max_distance;
+}
+
+/// <summary>
+/// Gets the posting list of a trigram
+/// </summary>
+/// <param name="key">The trigram key</param>
+/// <returns>The posting list (empty if no word has the trigram)</returns>
+TrigramIndex::PostingList TrigramIndex::postingList(const uint32_t &key) const
+{
+	PostingList list;
+	list.begin = postings.data();
+	list.end = postings.data();
+
+	std::vector<uint32_t>::const_iterator it = std::lower_bound(keys.begin(), keys.end(), key);
+	if (it != keys.end() && *it == key)
+	{
+		size_t slot = it - keys.begin();
+		list.begin = postings.data() + key_offsets[slot];
+		list.end = postings.data() + key_offsets[slot + 1];
+	}
+
+	return list;
+}
+
+#endif TrigramIndex_CPP
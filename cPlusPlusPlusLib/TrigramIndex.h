@@ -0,0 +1,88 @@
+/*
+* This is the header file for the TrigramIndex class of cPlusPlusPlusLib
+* cPPPLib - A library of functions that should be in the C++ Standard Library
+* (C) - Charles Machalow - MIT License
+*/
+
+#ifndef TrigramIndex_H
+#define TrigramIndex_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "SimilarityFunctions.h"
+#include "StringView.h"
+#include "ThreadPool.h"
+
+/// <summary>
+/// Index of the trigrams (3 char substrings) of every word in a dictionary, for fuzzy (edit distance) lookups.
+/// One edit changes at most 3 of a word's trigrams, so a word within d edits of the query shares all but 3 * d of the query's trigrams.
+/// Lookups use that to pick candidates from the posting lists of the rarest query trigrams, then check them with SimilarityFunctions.
+/// The dictionary is referenced, not copied: it must outlive the index and not change while the index is in use. It may hold up to 2^32 - 1 words.
+/// Lookups are const and safe to run from several threads at once.
+/// </summary>
+class TrigramIndex
+{
+public:
+	/// <summary>
+	/// A dictionary word found by a lookup. Matches order by distance, then by index.
+	/// </summary>
+	struct Match
+	{
+		size_t index;
+		size_t distance;
+
+		bool operator<(const Match &other) const;
+	};
+
+	TrigramIndex(const std::vector<std::string> &dictionary);
+	TrigramIndex(std::vector<std::string> &&dictionary) = delete;
+
+	std::vector<Match> topK(const StringView &query, const size_t &k, const size_t &max_distance = 2) const;
+	std::vector<Match> withinDistance(const StringView &query, const size_t &max_distance) const;
+	std::vector<size_t> candidates(const StringView &query, const size_t &max_distance) const;
+	size_t size() const;
+
+private:
+	/// <summary>
+	/// Posting list of one trigram: sorted indexes of the dictionary words holding it
+	/// </summary>
+	struct PostingList
+	{
+		const uint32_t *begin;
+		const uint32_t *end;
+	};
+
+	// Words are padded with 2 of these in front and 1 behind, so a word of n chars has n + 1 trigrams
+	static const char PAD = '\0';
+	// Trigrams are packed into 24 bit keys
+	static const size_t KEY_SPACE = 1 << 24;
+	// Word sizes are kept in a byte each, with this meaning "look at the word"
+	static const uint8_t LONG_WORD = 255;
+	// Candidates are checked this many at a time, so the distance bound can tighten between checks
+	static const size_t CHECK_BATCH_SIZE = 256;
+	// Lookups with at least this many candidates check them across ThreadPool::shared()
+	static const size_t PARALLEL_CHECK_SIZE = 65536;
+
+	static void trigramsOf(const StringView &word, std::vector<uint32_t> &keys);
+	static void addMatch(const Match &match, const size_t &k, std::vector<Match> &matches);
+	static bool skipTo(const uint32_t *&cursor, const uint32_t *end, const uint32_t &index);
+
+	void lookup(const StringView &query, const size_t &max_distance, const size_t &k, std::vector<Match> &matches) const;
+	void checkRange(const SimilarityFunctions::Pattern &pattern, const std::vector<uint32_t> &indexes, const size_t &begin, const size_t &end, const size_t &max_distance, const size_t &k, std::vector<Match> &matches) const;
+	void candidateIndexes(const StringView &query, const size_t &max_distance, std::vector<uint32_t> &out) const;
+	void wordsBySize(const size_t &query_size, const size_t &max_distance, std::vector<uint32_t> &out) const;
+	bool sizeWithin(const uint32_t &index, const size_t &query_size, const size_t &max_distance) const;
+	PostingList postingList(const uint32_t &key) const;
+
+	const std::vector<std::string> &dictionary;
+	std::vector<uint32_t> keys;
+	std::vector<uint64_t> key_offsets;
+	std::vector<uint32_t> postings;
+	std::vector<uint8_t> word_sizes;
+	std::vector<uint32_t> words_by_size;
+	std::vector<uint64_t> size_offsets;
+};
+
+#endif TrigramIndex_H
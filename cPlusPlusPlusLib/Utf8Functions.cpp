@@ -0,0 +1,699 @@
+/*
+* This is the cpp file for the Utf8Functions class of cPlusPlusPlusLib
+* cPPPLib - A library of functions that should be in the C++ Standard Library
+* (C) - Charles Machalow - MIT License
+*/
+
+#ifndef Utf8Functions_CPP
+#define Utf8Functions_CPP
+
+#include "Utf8Functions.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UTF8_USE_SSE2
+#include <emmintrin.h>
+#endif //SSE2
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif //_MSC_VER
+
+/// <summary>
+/// Determines if a range of chars is pure ASCII (no byte has its high bit set).
+/// Checks 64 bytes per step with SSE2 where available, otherwise 8 bytes per step.
+/// </summary>
+/// <param name="data">Pointer to the first char</param>
+/// <param name="size">Number of chars</param>
+/// <returns>True if every char is ASCII</returns>
+bool Utf8Functions::isAscii(const char *data, const size_t &size)
+{
+	size_t pos = 0;
+
+#ifdef UTF8_USE_SSE2
+	for (; pos + 64 <= size; pos += 64)
+	{
+		__m128i block = _mm_or_si128(
+			_mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos)), _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos + 16))),
+			_mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos + 32)), _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos + 48))));
+
+		if (_mm_movemask_epi8(block) != 0)
+		{
+			return false;
+		}
+	}
+#endif //UTF8_USE_SSE2
+
+	for (; pos + 8 <= size; pos += 8)
+	{
+		uint64_t word;
+		memcpy(&word, data + pos, sizeof(word));
+		if ((word & 0x8080808080808080ULL) != 0)
+		{
+			return false;
+		}
+	}
+
+	for (; pos < size; pos++)
+	{
+		if (static_cast<unsigned char>(data[pos]) >= 0x80)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/// <summary>
+/// Determines if the given std::string is pure ASCII
+/// </summary>
+/// <param name="original_str">The original std::string</param>
+/// <returns>True if every char is ASCII</returns>
+bool Utf8Functions::isAscii(const std::string &original_str)
+{
+	return Utf8Functions::isAscii(original_str.data(), original_str.size());
+}
+
+/// <summary>
+/// Determines if a range of chars is valid UTF-8 (RFC 3629: no overlong forms, surrogates or code points past U+10FFFF).
+/// Runs of ASCII are skipped with asciiRunLength(); only the multi-byte sequences between them are decoded.
+/// </summary>
+/// <param name="data">Pointer to the first char</param>
+/// <param name="size">Number of chars</param>
+/// <returns>True if the chars are valid UTF-8</returns>
+bool Utf8Functions::isValid(const char *data, const size_t &size)
+{
+	const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+	size_t pos = 0;
+
+	while (pos < size)
+	{
+		pos += Utf8Functions::asciiRunLength(data + pos, size - pos);
+
+		// Check multi-byte sequences one after another until the next ASCII byte
+		while (pos < size && bytes[pos] >= 0x80)
+		{
+			size_t length = Utf8Functions::sequenceLength(bytes + pos, size - pos);
+			if (length == 0)
+			{
+				return false;
+			}
+			pos += length;
+		}
+	}
+
+	return true;
+}
+
+/// <summary>
+/// Gets the number of ASCII chars at the start of a range of chars.
+/// Checks 16 bytes per step with SSE2 where available (8 otherwise) and jumps straight to the first byte with its high bit set.
+/// </summary>
+/// <param name="data">Pointer to the first char</param>
+/// <param name="size">Number of chars</param>
+/// <returns>Offset of the first non-ASCII char, or size if there is none</returns>
+size_t Utf8Functions::asciiRunLength(const char *data, const size_t &size)
+{
+	size_t pos = 0;
+
+#ifdef UTF8_USE_SSE2
+	for (; pos + 16 <= size; pos += 16)
+	{
+		int high_bits = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos)));
+		if (high_bits != 0)
+		{
+			return pos + Utf8Functions::lowestBit(static_cast<uint32_t>(high_bits));
+		}
+	}
+#else
+	for (; pos + 8 <= size; pos += 8)
+	{
+		uint64_t word;
+		memcpy(&word, data + pos, sizeof(word));
+		if ((word & 0x8080808080808080ULL) != 0)
+		{
+			break;
+		}
+	}
+#endif //UTF8_USE_SSE2
+
+	while (pos < size && static_cast<unsigned char>(data[pos]) < 0x80)
+	{
+		pos++;
+	}
+
+	return pos;
+}
+
+/// <summary>
+/// Gets the index of the lowest set bit
+/// </summary>
+/// <param name="bits">The bits. Must not be 0</param>
+/// <returns>Index of the lowest set bit</returns>
+size_t Utf8Functions::lowestBit(const uint32_t &bits)
+{
+#if defined(__GNUC__)
+	return static_cast<size_t>(__builtin_ctz(bits));
+#elif defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, bits);
+	return static_cast<size_t>(index);
+#else
+	size_t index = 0;
+	while (((bits >> index) & 1) == 0)
+	{
+		index++;
+	}
+	return index;
+#endif
+}
+
+/// <summary>
+/// Determines if the given std::string is valid UTF-8
+/// </summary>
+/// <param name="original_str">The original std::string</param>
+/// <returns>True if original_str is valid UTF-8</returns>
+bool Utf8Functions::isValid(const std::string &original_str)
+{
+	return Utf8Functions::isValid(original_str.data(), original_str.size());
+}
+
+/// <summary>
+/// Counts the code points in the given std::string
+/// </summary>
+/// <param name="original_str">The original std::string</param>
+/// <returns>Number of code points (each invalid byte counts as one)</returns>
+size_t Utf8Functions::codePointCount(const std::string &original_str)
+{
+	if (Utf8Functions::isAscii(original_str))
+	{
+		return original_str.size();
+	}
+
+	const unsigned char *bytes = reinterpret_cast<const unsigned char *>(original_str.data());
+	size_t count = 0;
+
+	for (size_t pos = 0; pos < original_str.size(); count++)
+	{
+		pos += std::max(Utf8Functions::sequenceLength(bytes + pos, original_str.size() - pos), static_cast<size_t>(1));
+	}
+
+	return count;
+}
+
+/// <summary>
+/// Gets the number of terminal columns the given std::string takes up.
+/// East Asian wide characters and emoji count as 2, combining marks as 0, everything else as 1.
+/// </summary>
+/// <param name="original_str">The original std::string</param>
+/// <returns>Display width in columns</returns>
+size_t Utf8Functions::displayWidth(const std::string &original_str)
+{
+	if (Utf8Functions::isAscii(original_str))
+	{
+		return original_str.size();
+	}
+
+	const unsigned char *bytes = reinterpret_cast<const unsigned char *>(original_str.data());
+	size_t width = 0;
+
+	for (size_t pos = 0; pos < original_str.size();)
+	{
+		uint32_t code_point = 0;
+		pos += Utf8Functions::decode(bytes + pos, original_str.size() - pos, code_point);
+		width += Utf8Functions::codePointWidth(code_point);
+	}
+
+	return width;
+}
+
+/// <summary>
+/// Slices the specified original_str by code point using a python-style slice.
+/// Same slice syntax and error handling as StringFunctions::slice().
+/// </summary>
+/// <param name="original_str">The original std::string (UTF-8)</param>
+/// <param name="slice_str">slicing info as string ex: "[1:3]"</param>
+/// <returns>std::string slice from original_str with no code point cut in half. Returns "" on error</returns>
+std::string Utf8Functions::slice(const std::string &original_str, const std::string &slice_str)
+{
+	if (Utf8Functions::isAscii(original_str))
+	{
+		return StringFunctions::slice(original_str, slice_str);
+	}
+
+	std::vector<size_t> offsets = Utf8Functions::codePointOffsets(original_str);
+	size_t start = 0;
+	size_t count = 0;
+
+	// offsets has one extra trailing entry (the byte size)
+	if (!StringFunctions::resolveSlice(slice_str, offsets.size() - 1, start, count))
+	{
+		return "";
+	}
+
+	return original_str.substr(offsets[start], offsets[start + count] - offsets[start]);
+}
+
+/// <summary>
+/// Reverses the given std::string by code point, so multi-byte sequences stay intact
+/// </summary>
+/// <param name="original_str">The original std::string (UTF-8)</param>
+/// <returns>original_str with its code points in reverse order</returns>
+std::string Utf8Functions::reverse(const std::string &original_str)
+{
+	if (Utf8Functions::isAscii(original_str))
+	{
+		return StringFunctions::reverse(original_str);
+	}
+
+	std::vector<size_t> offsets = Utf8Functions::codePointOffsets(original_str);
+	std::string ret_str;
+	ret_str.reserve(original_str.size());
+
+	for (size_t i = offsets.size() - 1; i > 0; i--)
+	{
+		ret_str.append(original_str, offsets[i - 1], offsets[i] - offsets[i - 1]);
+	}
+
+	return ret_str;
+}
+
+/// <summary>
+/// Justifies the original std::string to the left by adding fill_char to the right until it is expected_width columns wide
+/// </summary>
+/// <param name="original_str">The original std::string (UTF-8)</param>
+/// <param name="expected_width">The display width of the returned std::string (unless original_str is already wider)</param>
+/// <param name="fill_char">An ASCII char to pad (the right of) the returning std::string with</param>
+/// <returns>A std::string at least expected_width columns wide</returns>
+std::string Utf8Functions::ljust(const std::string &original_str, const unsigned int &expected_width, const char &fill_char)
+{
+	size_t width = Utf8Functions::displayWidth(original_str);
+	std::string ret_str = original_str;
+
+	if (width < expected_width)
+	{
+		ret_str.append(expected_width - width, fill_char);
+	}
+
+	return ret_str;
+}
+
+/// <summary>
+/// Justifies the original std::string to the right by adding fill_char to the left until it is expected_width columns wide
+/// </summary>
+/// <param name="original_str">The original std::string (UTF-8)</param>
+/// <param name="expected_width">The display width of the returned std::string (unless original_str is already wider)</param>
+/// <param name="fill_char">An ASCII char to pad (the left of) the returning std::string with</param>
+/// <returns>A std::string at least expected_width columns wide</returns>
+std::string Utf8Functions::rjust(const std::string &original_str, const unsigned int &expected_width, const char &fill_char)
+{
+	size_t width = Utf8Functions::displayWidth(original_str);
+	std::string ret_str = original_str;
+
+	if (width < expected_width)
+	{
+		ret_str.insert(0, expected_width - width, fill_char);
+	}
+
+	return ret_str;
+}
+
+/// <summary>
+/// Returns a copy of the given string in UPPERCASE.
+/// Covers ASCII, Latin-1, Latin Extended-A, basic Greek and basic Cyrillic; other code points are copied as is.
+/// </summary>
+/// <param name="original_str">The original std::string (UTF-8)</param>
+/// <returns>Copy of original_str in UPPERCASE</returns>
+std::string Utf8Functions::toUpperCase(const std::string &original_str)
+{
+	if (Utf8Functions::isAscii(original_str))
+	{
+		return StringFunctions::toUpperCase(original_str);
+	}
+
+	const unsigned char *bytes = reinterpret_cast<const unsigned char *>(original_str.data());
+	std::string ret_str;
+	ret_str.reserve(original_str.size());
+
+	for (size_t pos = 0; pos < original_str.size();)
+	{
+		uint32_t code_point = 0;
+		size_t length = Utf8Functions::sequenceLength(bytes + pos, original_str.size() - pos);
+
+		if (length == 0)
+		{
+			ret_str += original_str[pos];
+			pos++;
+			continue;
+		}
+
+		Utf8Functions::decode(bytes + pos, length, code_point);
+		Utf8Functions::appendCodePoint(ret_str, Utf8Functions::codePointToUpper(code_point));
+		pos += length;
+	}
+
+	return ret_str;
+}
+
+/// <summary>
+/// Returns a copy of the given string in lowercase.
+/// Covers ASCII, Latin-1, Latin Extended-A, basic Greek and basic Cyrillic; other code points are copied as is.
+/// </summary>
+/// <param name="original_str">The original std::string (UTF-8)</param>
+/// <returns>Copy of original_str in lowercase</returns>
+std::string Utf8Functions::toLowerCase(const std::string &original_str)
+{
+	if (Utf8Functions::isAscii(original_str))
+	{
+		return StringFunctions::toLowerCase(original_str);
+	}
+
+	const unsigned char *bytes = reinterpret_cast<const unsigned char *>(original_str.data());
+	std::string ret_str;
+	ret_str.reserve(original_str.size());
+
+	for (size_t pos = 0; pos < original_str.size();)
+	{
+		uint32_t code_point = 0;
+		size_t length = Utf8Functions::sequenceLength(bytes + pos, original_str.size() - pos);
+
+		if (length == 0)
+		{
+			ret_str += original_str[pos];
+			pos++;
+			continue;
+		}
+
+		Utf8Functions::decode(bytes + pos, length, code_point);
+		Utf8Functions::appendCodePoint(ret_str, Utf8Functions::codePointToLower(code_point));
+		pos += length;
+	}
+
+	return ret_str;
+}
+
+/// <summary>
+/// Appends the UTF-8 encoding of a code point to the given std::string
+/// </summary>
+/// <param name="str">The std::string to append to</param>
+/// <param name="code_point">The code point. Surrogates and values past U+10FFFF are appended as U+FFFD</param>
+void Utf8Functions::appendCodePoint(std::string &str, const uint32_t &code_point)
+{
+	uint32_t cp = code_point;
+	if ((cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF)
+	{
+		cp = 0xFFFD;
+	}
+
+	if (cp < 0x80)
+	{
+		str += static_cast<char>(cp);
+	}
+	else if (cp < 0x800)
+	{
+		str += static_cast<char>(0xC0 | (cp >> 6));
+		str += static_cast<char>(0x80 | (cp & 0x3F));
+	}
+	else if (cp < 0x10000)
+	{
+		str += static_cast<char>(0xE0 | (cp >> 12));
+		str += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+		str += static_cast<char>(0x80 | (cp & 0x3F));
+	}
+	else
+	{
+		str += static_cast<char>(0xF0 | (cp >> 18));
+		str += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+		str += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+		str += static_cast<char>(0x80 | (cp & 0x3F));
+	}
+}
+
+/// <summary>
+/// Gets the length of the valid UTF-8 sequence starting at data
+/// </summary>
+/// <param name="data">Pointer to the lead byte</param>
+/// <param name="remaining">Bytes available from data onwards (at least 1)</param>
+/// <returns>1 to 4 for a valid sequence, 0 if the sequence is invalid or truncated</returns>
+size_t Utf8Functions::sequenceLength(const unsigned char *data, const size_t &remaining)
+{
+	unsigned char lead = data[0];
+	size_t length = 0;
+	unsigned char second_min = 0x80;
+	unsigned char second_max = 0xBF;
+
+	if (lead < 0x80)
+	{
+		return 1;
+	}
+	else if (lead >= 0xC2 && lead <= 0xDF)
+	{
+		length = 2;
+	}
+	else if (lead >= 0xE0 && lead <= 0xEF)
+	{
+		length = 3;
+		if (lead == 0xE0)
+		{
+			// Overlong
+			second_min = 0xA0;
+		}
+		else if (lead == 0xED)
+		{
+			// Surrogates
+			second_max = 0x9F;
+		}
+	}
+	else if (lead >= 0xF0 && lead <= 0xF4)
+	{
+		length = 4;
+		if (lead == 0xF0)
+		{
+			// Overlong
+			second_min = 0x90;
+		}
+		else if (lead == 0xF4)
+		{
+			// Past U+10FFFF
+			second_max = 0x8F;
+		}
+	}
+	else
+	{
+		return 0;
+	}
+
+	if (remaining < length || data[1] < second_min || data[1] > second_max)
+	{
+		return 0;
+	}
+
+	for (size_t i = 2; i < length; i++)
+	{
+		if ((data[i] & 0xC0) != 0x80)
+		{
+			return 0;
+		}
+	}
+
+	return length;
+}
+
+/// <summary>
+/// Decodes the code point starting at data
+/// </summary>
+/// <param name="data">Pointer to the lead byte</param>
+/// <param name="remaining">Bytes available from data onwards (at least 1)</param>
+/// <param name="code_point">Gets the code point, or U+FFFD if the sequence is invalid</param>
+/// <returns>Bytes consumed. Always at least 1 so invalid bytes are skipped one at a time</returns>
+size_t Utf8Functions::decode(const unsigned char *data, const size_t &remaining, uint32_t &code_point)
+{
+	size_t length = Utf8Functions::sequenceLength(data, remaining);
+
+	switch (length)
+	{
+	case 1:
+		code_point = data[0];
+		return 1;
+	case 2:
+		code_point = ((data[0] & 0x1F) << 6) | (data[1] & 0x3F);
+		return 2;
+	case 3:
+		code_point = ((data[0] & 0x0F) << 12) | ((data[1] & 0x3F) << 6) | (data[2] & 0x3F);
+		return 3;
+	case 4:
+		code_point = ((data[0] & 0x07) << 18) | ((data[1] & 0x3F) << 12) | ((data[2] & 0x3F) << 6) | (data[3] & 0x3F);
+		return 4;
+	default:
+		code_point = 0xFFFD;
+		return 1;
+	}
+}
+
+/// <summary>
+/// Gets the byte offset of every code point in the given std::string
+/// </summary>
+/// <param name="original_str">The original std::string</param>
+/// <returns>std::vector<size_t> of byte offsets, with original_str.size() appended at the end</returns>
+std::vector<size_t> Utf8Functions::codePointOffsets(const std::string &original_str)
+{
+	const unsigned char *bytes = reinterpret_cast<const unsigned char *>(original_str.data());
+	std::vector<size_t> offsets;
+	offsets.reserve(original_str.size() + 1);
+
+	for (size_t pos = 0; pos < original_str.size();)
+	{
+		offsets.push_back(pos);
+		pos += std::max(Utf8Functions::sequenceLength(bytes + pos, original_str.size() - pos), static_cast<size_t>(1));
+	}
+	offsets.push_back(original_str.size());
+
+	return offsets;
+}
+
+/// <summary>
+/// Gets the number of terminal columns a code point takes up
+/// </summary>
+/// <param name="code_point">The code point</param>
+/// <returns>0 for combining marks and zero width characters, 2 for wide characters, otherwise 1</returns>
+unsigned int Utf8Functions::codePointWidth(const uint32_t &code_point)
+{
+	static const uint32_t ZERO_WIDTH[][2] = {
+		{ 0x0300, 0x036F }, { 0x0483, 0x0489 }, { 0x0591, 0x05BD }, { 0x0610, 0x061A }, { 0x064B, 0x065F },
+		{ 0x0E31, 0x0E31 }, { 0x0E34, 0x0E3A }, { 0x200B, 0x200F }, { 0x20D0, 0x20FF }, { 0xFE00, 0xFE0F }, { 0xFE20, 0xFE2F },
+	};
+	static const uint32_t DOUBLE_WIDTH[][2] = {
+		{ 0x1100, 0x115F }, { 0x2E80, 0x303E }, { 0x3041, 0x33FF }, { 0x3400, 0x4DBF }, { 0x4E00, 0x9FFF }, { 0xA000, 0xA4CF },
+		{ 0xAC00, 0xD7A3 }, { 0xF900, 0xFAFF }, { 0xFE30, 0xFE4F }, { 0xFF00, 0xFF60 }, { 0xFFE0, 0xFFE6 },
+		{ 0x1F300, 0x1F64F }, { 0x1F900, 0x1F9FF }, { 0x20000, 0x2FFFD }, { 0x30000, 0x3FFFD },
+	};
+
+	if (code_point < 0x300)
+	{
+		return 1;
+	}
+
+	for (const uint32_t *range : ZERO_WIDTH)
+	{
+		if (code_point >= range[0] && code_point <= range[1])
+		{
+			return 0;
+		}
+	}
+
+	for (const uint32_t *range : DOUBLE_WIDTH)
+	{
+		if (code_point >= range[0] && code_point <= range[1])
+		{
+			return 2;
+		}
+	}
+
+	return 1;
+}
+
+/// <summary>
+/// Maps a code point to UPPERCASE
+/// </summary>
+/// <param name="code_point">The code point</param>
+/// <returns>The UPPERCASE code point, or code_point if there is no (covered) mapping</returns>
+uint32_t Utf8Functions::codePointToUpper(const uint32_t &code_point)
+{
+	uint32_t cp = code_point;
+
+	if (cp >= 'a' && cp <= 'z')
+	{
+		return cp - 0x20;
+	}
+	// Latin-1 Supplement
+	if (cp >= 0xE0 && cp <= 0xFE && cp != 0xF7)
+	{
+		return cp - 0x20;
+	}
+	if (cp == 0xFF)
+	{
+		return 0x178;
+	}
+	// Latin Extended-A: pairs with the uppercase letter first
+	if (((cp >= 0x100 && cp <= 0x12F) || (cp >= 0x132 && cp <= 0x137) || (cp >= 0x14A && cp <= 0x177)) && (cp & 1) == 1)
+	{
+		return cp - 1;
+	}
+	if (((cp >= 0x139 && cp <= 0x148) || (cp >= 0x179 && cp <= 0x17E)) && (cp & 1) == 0)
+	{
+		return cp - 1;
+	}
+	// Greek
+	if (cp == 0x3C2)
+	{
+		return 0x3A3;
+	}
+	if (cp >= 0x3B1 && cp <= 0x3C9)
+	{
+		return cp - 0x20;
+	}
+	// Cyrillic
+	if (cp >= 0x430 && cp <= 0x44F)
+	{
+		return cp - 0x20;
+	}
+	if (cp >= 0x450 && cp <= 0x45F)
+	{
+		return cp - 0x50;
+	}
+
+	return cp;
+}
+
+/// <summary>
+/// Maps a code point to lowercase
+/// </summary>
+/// <param name="code_point">The code point</param>
+/// <returns>The lowercase code point, or code_point if there is no (covered) mapping</returns>
+uint32_t Utf8Functions::codePointToLower(const uint32_t &code_point)
+{
+	uint32_t cp = code_point;
+
+	if (cp >= 'A' && cp <= 'Z')
+	{
+		return cp + 0x20;
+	}
+	// Latin-1 Supplement
+	if (cp >= 0xC0 && cp <= 0xDE && cp != 0xD7)
+	{
+		return cp + 0x20;
+	}
+	if (cp == 0x178)
+	{
+		return 0xFF;
+	}
+	// Latin Extended-A: pairs with the uppercase letter first
+	if (((cp >= 0x100 && cp <= 0x12F) || (cp >= 0x132 && cp <= 0x137) || (cp >= 0x14A && cp <= 0x177)) && (cp & 1) == 0)
+	{
+		return cp + 1;
+	}
+	if (((cp >= 0x139 && cp <= 0x148) || (cp >= 0x179 && cp <= 0x17E)) && (cp & 1) == 1)
+	{
+		return cp + 1;
+	}
+	// Greek (0x3A2 is unassigned)
+	if (cp >= 0x391 && cp <= 0x3A9 && cp != 0x3A2)
+	{
+		return cp + 0x20;
+	}
+	// Cyrillic
+	if (cp >= 0x410 && cp <= 0x42F)
+	{
+		return cp + 0x20;
+	}
+	if (cp >= 0x400 && cp <= 0x40F)
+	{
+		return cp + 0x50;
+	}
+
+	return cp;
+}
+
+#endif Utf8Functions_CPP
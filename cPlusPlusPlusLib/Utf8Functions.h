@@ -0,0 +1,52 @@
+/*
+* This is the header file for the Utf8Functions class of cPlusPlusPlusLib
+* cPPPLib - A library of functions that should be in the C++ Standard Library
+* (C) - Charles Machalow - MIT License
+*/
+
+#ifndef Utf8Functions_H
+#define Utf8Functions_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "StringFunctions.h"
+
+/// <summary>
+/// Class for functions on UTF-8 encoded std::strings.
+/// Pure ASCII input is detected up front and handed to the byte based StringFunctions.
+/// Invalid bytes are treated as single code points and passed through untouched.
+/// </summary>
+class Utf8Functions
+{
+public:
+	static bool isAscii(const char *data, const size_t &size);
+	static bool isAscii(const std::string &original_str);
+	static bool isValid(const char *data, const size_t &size);
+	static bool isValid(const std::string &original_str);
+
+	static size_t codePointCount(const std::string &original_str);
+	static size_t displayWidth(const std::string &original_str);
+
+	static std::string slice(const std::string &original_str, const std::string &slice_str);
+	static std::string reverse(const std::string &original_str);
+	static std::string ljust(const std::string &original_str, const unsigned int &expected_width, const char &fill_char = ' ');
+	static std::string rjust(const std::string &original_str, const unsigned int &expected_width, const char &fill_char = ' ');
+	static std::string toUpperCase(const std::string &original_str);
+	static std::string toLowerCase(const std::string &original_str);
+
+	static void appendCodePoint(std::string &str, const uint32_t &code_point);
+
+private:
+	static size_t asciiRunLength(const char *data, const size_t &size);
+	static size_t lowestBit(const uint32_t &bits);
+	static size_t sequenceLength(const unsigned char *data, const size_t &remaining);
+	static size_t decode(const unsigned char *data, const size_t &remaining, uint32_t &code_point);
+	static std::vector<size_t> codePointOffsets(const std::string &original_str);
+	static unsigned int codePointWidth(const uint32_t &code_point);
+	static uint32_t codePointToUpper(const uint32_t &code_point);
+	static uint32_t codePointToLower(const uint32_t &code_point);
+};
+
+#endif Utf8Functions_H
@@ -9,6 +9,89 @@
 
 #include "UtilityFunctions.h"
 
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UTILITY_USE_SSE2
+#include <emmintrin.h>
+#endif //SSE2
+
+static const char BASE64_ALPHABETS[2][65] = {
+	"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/",
+	"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"
+};
+
+// Set in a base64 decode table entry for chars outside the alphabet. Never overlaps the 24 decoded bits.
+static const uint32_t BASE64_INVALID = 0x01000000;
+
+/// <summary>
+/// Lookup tables for base64, for both the standard (index 0) and URL-safe (index 1) alphabets.
+/// encode_pairs maps 12 bits to 2 chars, so 3 bytes take 2 lookups.
+/// decode maps a char at each of the 4 positions of a group straight to its bits within the 3 decoded bytes,
+/// so a group decodes with 4 lookups OR'd together.
+/// </summary>
+struct Base64Tables
+{
+	char encode_pairs[2][4096][2];
+	uint32_t decode[2][4][256];
+
+	Base64Tables()
+	{
+		for (size_t alphabet = 0; alphabet < 2; alphabet++)
+		{
+			for (size_t bits = 0; bits < 4096; bits++)
+			{
+				encode_pairs[alphabet][bits][0] = BASE64_ALPHABETS[alphabet][bits >> 6];
+				encode_pairs[alphabet][bits][1] = BASE64_ALPHABETS[alphabet][bits & 0x3F];
+			}
+
+			for (size_t position = 0; position < 4; position++)
+			{
+				for (size_t c = 0; c < 256; c++)
+				{
+					decode[alphabet][position][c] = BASE64_INVALID;
+				}
+				for (uint32_t value = 0; value < 64; value++)
+				{
+					unsigned char c = static_cast<unsigned char>(BASE64_ALPHABETS[alphabet][value]);
+					decode[alphabet][position][c] = value << (18 - 6 * position);
+				}
+			}
+		}
+	}
+};
+
+/// <summary>
+/// Gets the base64 lookup tables, building them on first use
+/// </summary>
+/// <returns>The Base64Tables</returns>
+static const Base64Tables &base64Tables()
+{
+	static const Base64Tables tables;
+	return tables;
+}
+
+/// <summary>
+/// Gets the value of a hex digit
+/// </summary>
+/// <param name="c">The char</param>
+/// <returns>0 to 15, or -1 if c is not a hex digit</returns>
+static int hexDigitValue(const unsigned char &c)
+{
+	if (static_cast<unsigned char>(c - '0') <= 9)
+	{
+		return c - '0';
+	}
+
+	unsigned char lower = c | 0x20;
+	if (static_cast<unsigned char>(lower - 'a') <= 5)
+	{
+		return lower - 'a' + 10;
+	}
+
+	return -1;
+}
+
 /// <summary>
 /// Determines whether this computer uses big endian ordering
 /// </summary>
@@ -76,7 +159,7 @@ bool UtilityFunctions::getFreeSpaceInBytes(uint64_t &space, const std::string &p
 		perror("statfs() failed");
 		return false;
 	}
-	space = static_cast<uint64_t>(buf.f_bsize) * static_cast<uint64_t>(buf.f_blocks);
+	space = static_cast<uint64_t>(buf.f_bsize) * static_cast<uint64_t>(buf.f_bavail);
 
 	return true;
 #endif //__linux
@@ -166,4 +249,739 @@ std::vector<uint8_t> UtilityFunctions::numericToBEBytes(const uint64_t &numeric)
 	return bytes;
 }
 
+/// <summary>
+/// Gets the number of chars needed to hex encode some bytes
+/// </summary>
+/// <param name="size">Number of bytes</param>
+/// <returns>Number of hex chars</returns>
+size_t UtilityFunctions::hexEncodedSize(const size_t &size)
+{
+	return size * 2;
+}
+
+/// <summary>
+/// Hex encodes bytes into a caller supplied buffer (no null terminator is written).
+/// Encodes 16 bytes per step with SSE2 where available.
+/// </summary>
+/// <param name="data">Pointer to the first byte</param>
+/// <param name="size">Number of bytes</param>
+/// <param name="out">Buffer for the hex chars</param>
+/// <param name="out_size">Size of out in chars. Must be at least hexEncodedSize(size)</param>
+/// <param name="upper_case">If True, use A-F rather than a-f (Defaults to False)</param>
+/// <returns>Number of chars written, or 0 if out is too small</returns>
+size_t UtilityFunctions::hexEncode(const uint8_t *data, const size_t &size, char *out, const size_t &out_size, const bool &upper_case)
+{
+	size_t needed = UtilityFunctions::hexEncodedSize(size);
+	if (out_size < needed)
+	{
+		return 0;
+	}
+
+	UtilityFunctions::hexEncodeBlock(data, size, out, upper_case);
+	return needed;
+}
+
+/// <summary>
+/// Hex encodes a std::vector<uint8_t> of bytes
+/// </summary>
+/// <param name="bytes">The bytes</param>
+/// <param name="upper_case">If True, use A-F rather than a-f (Defaults to False)</param>
+/// <returns>std::string of hex chars</returns>
+std::string UtilityFunctions::hexEncode(const std::vector<uint8_t> &bytes, const bool &upper_case)
+{
+	std::string ret_str(UtilityFunctions::hexEncodedSize(bytes.size()), '\0');
+	if (!bytes.empty())
+	{
+		UtilityFunctions::hexEncodeBlock(bytes.data(), bytes.size(), &ret_str[0], upper_case);
+	}
+	return ret_str;
+}
+
+/// <summary>
+/// Decodes hex into a caller supplied buffer. Upper and lower case digits are accepted, nothing else is.
+/// Decodes 16 chars per step with SSE2 where available.
+/// </summary>
+/// <param name="data">Pointer to the first hex char</param>
+/// <param name="size">Number of hex chars. Must be even</param>
+/// <param name="out">Buffer for the bytes</param>
+/// <param name="out_size">Size of out in bytes. Must be at least size / 2</param>
+/// <param name="written">size_t, passed by reference. Gets the number of bytes decoded.
+/// On failure from a bad char, the bad char is at data[written * 2] or data[written * 2 + 1]</param>
+/// <returns>True on success, False if size is odd, out is too small or a char is not a hex digit</returns>
+bool UtilityFunctions::hexDecode(const char *data, const size_t &size, uint8_t *out, const size_t &out_size, size_t &written)
+{
+	written = 0;
+	if (size % 2 != 0 || out_size < size / 2)
+	{
+		return false;
+	}
+
+	written = UtilityFunctions::hexDecodeBlock(data, size, out);
+	return written == size / 2;
+}
+
+/// <summary>
+/// Decodes a std::string of hex
+/// </summary>
+/// <param name="hex_str">The hex std::string</param>
+/// <param name="bytes">std::vector<uint8_t>, passed by reference. On success, will get the decoded bytes</param>
+/// <returns>True on success, False if hex_str has odd length or a char that is not a hex digit</returns>
+bool UtilityFunctions::hexDecode(const std::string &hex_str, std::vector<uint8_t> &bytes)
+{
+	std::vector<uint8_t> decoded(hex_str.size() / 2);
+	size_t written = 0;
+
+	if (!UtilityFunctions::hexDecode(hex_str.data(), hex_str.size(), decoded.data(), decoded.size(), written))
+	{
+		return false;
+	}
+
+	bytes.swap(decoded);
+	return true;
+}
+
+/// <summary>
+/// Gets the number of chars needed to base64 encode some bytes
+/// </summary>
+/// <param name="size">Number of bytes</param>
+/// <param name="url_safe">If True, size for URL-safe base64, which is not padded (Defaults to False)</param>
+/// <returns>Number of base64 chars</returns>
+size_t UtilityFunctions::base64EncodedSize(const size_t &size, const bool &url_safe)
+{
+	if (url_safe)
+	{
+		size_t remainder = size % 3;
+		return size / 3 * 4 + (remainder == 0 ? 0 : remainder + 1);
+	}
+	return (size + 2) / 3 * 4;
+}
+
+/// <summary>
+/// Gets the most bytes some base64 chars can decode to
+/// </summary>
+/// <param name="size">Number of base64 chars</param>
+/// <returns>Max number of decoded bytes. Exact for unpadded base64</returns>
+size_t UtilityFunctions::base64DecodedSize(const size_t &size)
+{
+	size_t remainder = size % 4;
+	return size / 4 * 3 + (remainder == 0 ? 0 : remainder - 1);
+}
+
+/// <summary>
+/// Base64 encodes bytes into a caller supplied buffer (no null terminator is written)
+/// </summary>
+/// <param name="data">Pointer to the first byte</param>
+/// <param name="size">Number of bytes</param>
+/// <param name="out">Buffer for the base64 chars</param>
+/// <param name="out_size">Size of out in chars. Must be at least base64EncodedSize(size, url_safe)</param>
+/// <param name="url_safe">If True, use the URL-safe alphabet ('-' and '_') without padding (Defaults to False)</param>
+/// <returns>Number of chars written, or 0 if out is too small</returns>
+size_t UtilityFunctions::base64Encode(const uint8_t *data, const size_t &size, char *out, const size_t &out_size, const bool &url_safe)
+{
+	if (out_size < UtilityFunctions::base64EncodedSize(size, url_safe))
+	{
+		return 0;
+	}
+
+	size_t body = size / 3 * 3;
+	UtilityFunctions::base64EncodeBlock(data, body, out, url_safe);
+	return body / 3 * 4 + UtilityFunctions::base64EncodeTail(data + body, size - body, out + body / 3 * 4, url_safe);
+}
+
+/// <summary>
+/// Base64 encodes a std::vector<uint8_t> of bytes
+/// </summary>
+/// <param name="bytes">The bytes</param>
+/// <param name="url_safe">If True, use the URL-safe alphabet ('-' and '_') without padding (Defaults to False)</param>
+/// <returns>std::string of base64 chars</returns>
+std::string UtilityFunctions::base64Encode(const std::vector<uint8_t> &bytes, const bool &url_safe)
+{
+	std::string ret_str(UtilityFunctions::base64EncodedSize(bytes.size(), url_safe), '\0');
+	if (!bytes.empty())
+	{
+		UtilityFunctions::base64Encode(bytes.data(), bytes.size(), &ret_str[0], ret_str.size(), url_safe);
+	}
+	return ret_str;
+}
+
+/// <summary>
+/// Decodes base64 into a caller supplied buffer.
+/// Decoding is strict: no whitespace, no chars from the other alphabet, and unused bits of the last group must be zero.
+/// Standard base64 must be padded with '=', for URL-safe base64 the padding is optional.
+/// </summary>
+/// <param name="data">Pointer to the first base64 char</param>
+/// <param name="size">Number of base64 chars</param>
+/// <param name="out">Buffer for the bytes</param>
+/// <param name="out_size">Size of out in bytes. base64DecodedSize(size) is always enough</param>
+/// <param name="written">size_t, passed by reference. Gets the number of bytes decoded.
+/// On failure from a bad char, the bad char is in the group starting at data[written / 3 * 4]</param>
+/// <param name="url_safe">If True, use the URL-safe alphabet ('-' and '_') (Defaults to False)</param>
+/// <returns>True on success, False if out is too small or the base64 is malformed</returns>
+bool UtilityFunctions::base64Decode(const char *data, const size_t &size, uint8_t *out, const size_t &out_size, size_t &written, const bool &url_safe)
+{
+	written = 0;
+
+	size_t tail = size % 4;
+	size_t padding = 0;
+	if (tail == 0 && size > 0 && data[size - 1] == '=')
+	{
+		tail = 4;
+		padding = data[size - 2] == '=' ? 2 : 1;
+	}
+
+	if (tail == 1 || out_size < UtilityFunctions::base64DecodedSize(size) - padding)
+	{
+		return false;
+	}
+
+	size_t body = size - tail;
+	written = UtilityFunctions::base64DecodeBlock(data, body, out, url_safe);
+	if (written != body / 4 * 3)
+	{
+		return false;
+	}
+
+	if (tail != 0)
+	{
+		size_t tail_written = 0;
+		if (!UtilityFunctions::base64DecodeTail(data + body, tail, out + written, tail_written, url_safe))
+		{
+			return false;
+		}
+		written += tail_written;
+	}
+
+	return true;
+}
+
+/// <summary>
+/// Decodes a std::string of base64
+/// </summary>
+/// <param name="base64_str">The base64 std::string</param>
+/// <param name="bytes">std::vector<uint8_t>, passed by reference. On success, will get the decoded bytes</param>
+/// <param name="url_safe">If True, use the URL-safe alphabet ('-' and '_') (Defaults to False)</param>
+/// <returns>True on success, False if the base64 is malformed</returns>
+bool UtilityFunctions::base64Decode(const std::string &base64_str, std::vector<uint8_t> &bytes, const bool &url_safe)
+{
+	std::vector<uint8_t> decoded(UtilityFunctions::base64DecodedSize(base64_str.size()));
+	size_t written = 0;
+
+	if (!UtilityFunctions::base64Decode(base64_str.data(), base64_str.size(), decoded.data(), decoded.size(), written, url_safe))
+	{
+		return false;
+	}
+
+	decoded.resize(written);
+	bytes.swap(decoded);
+	return true;
+}
+
+/// <summary>
+/// Constructor for a HexDecoder
+/// </summary>
+UtilityFunctions::HexDecoder::HexDecoder() : pending(0), has_pending(false), error(false)
+{
+}
+
+/// <summary>
+/// Decodes the next chunk of hex. An odd char at the end of the chunk is held until the next chunk.
+/// </summary>
+/// <param name="data">Pointer to the first hex char of the chunk</param>
+/// <param name="size">Number of hex chars in the chunk</param>
+/// <param name="out">Buffer for the bytes</param>
+/// <param name="out_size">Size of out in bytes. (size + 1) / 2 is always enough</param>
+/// <param name="written">size_t, passed by reference. Gets the number of bytes decoded</param>
+/// <returns>True on success. False if out is too small (nothing is consumed),
+/// or if a char is not a hex digit (all later calls will also fail)</returns>
+bool UtilityFunctions::HexDecoder::update(const char *data, const size_t &size, uint8_t *out, const size_t &out_size, size_t &written)
+{
+	written = 0;
+	if (error || out_size < (size + (has_pending ? 1 : 0)) / 2)
+	{
+		return false;
+	}
+
+	size_t pos = 0;
+	if (has_pending && size > 0)
+	{
+		char pair[2] = { pending, data[0] };
+		if (UtilityFunctions::hexDecodeBlock(pair, 2, out) != 1)
+		{
+			error = true;
+			return false;
+		}
+		written = 1;
+		pos = 1;
+		has_pending = false;
+	}
+
+	size_t even = (size - pos) & ~static_cast<size_t>(1);
+	size_t decoded = UtilityFunctions::hexDecodeBlock(data + pos, even, out + written);
+	written += decoded;
+	if (decoded != even / 2)
+	{
+		error = true;
+		return false;
+	}
+
+	pos += even;
+	if (pos < size)
+	{
+		pending = data[pos];
+		has_pending = true;
+	}
+
+	return true;
+}
+
+/// <summary>
+/// Ends the hex stream, leaving the HexDecoder ready for a new one
+/// </summary>
+/// <returns>True if every chunk decoded and no odd char is left over</returns>
+bool UtilityFunctions::HexDecoder::finish()
+{
+	bool ret = !error && !has_pending;
+	has_pending = false;
+	error = false;
+	return ret;
+}
+
+/// <summary>
+/// Constructor for a Base64Encoder
+/// </summary>
+/// <param name="url_safe">If True, use the URL-safe alphabet ('-' and '_') without padding (Defaults to False)</param>
+UtilityFunctions::Base64Encoder::Base64Encoder(const bool &url_safe) : url_safe(url_safe), pending_count(0)
+{
+}
+
+/// <summary>
+/// Encodes the next chunk of bytes. Up to 2 bytes at the end of the chunk are held until the next chunk or finish().
+/// </summary>
+/// <param name="data">Pointer to the first byte of the chunk</param>
+/// <param name="size">Number of bytes in the chunk</param>
+/// <param name="out">Buffer for the base64 chars</param>
+/// <param name="out_size">Size of out in chars. (size + 2) / 3 * 4 is always enough</param>
+/// <param name="written">size_t, passed by reference. Gets the number of chars written</param>
+/// <returns>True on success, False if out is too small (nothing is consumed)</returns>
+bool UtilityFunctions::Base64Encoder::update(const uint8_t *data, const size_t &size, char *out, const size_t &out_size, size_t &written)
+{
+	written = 0;
+	if (size == 0)
+	{
+		return true;
+	}
+
+	if (out_size < (pending_count + size) / 3 * 4)
+	{
+		return false;
+	}
+
+	size_t pos = 0;
+	if (pending_count > 0)
+	{
+		if (pending_count + size < 3)
+		{
+			memcpy(pending + pending_count, data, size);
+			pending_count += size;
+			return true;
+		}
+
+		uint8_t group[3];
+		memcpy(group, pending, pending_count);
+		pos = 3 - pending_count;
+		memcpy(group + pending_count, data, pos);
+		UtilityFunctions::base64EncodeBlock(group, 3, out, url_safe);
+		written = 4;
+		pending_count = 0;
+	}
+
+	size_t body = (size - pos) / 3 * 3;
+	UtilityFunctions::base64EncodeBlock(data + pos, body, out + written, url_safe);
+	written += body / 3 * 4;
+	pos += body;
+
+	pending_count = size - pos;
+	memcpy(pending, data + pos, pending_count);
+	return true;
+}
+
+/// <summary>
+/// Encodes any held bytes, adding padding for standard base64, leaving the Base64Encoder ready for a new stream
+/// </summary>
+/// <param name="out">Buffer for the base64 chars</param>
+/// <param name="out_size">Size of out in chars. 4 is always enough</param>
+/// <param name="written">size_t, passed by reference. Gets the number of chars written</param>
+/// <returns>True on success, False if out is too small</returns>
+bool UtilityFunctions::Base64Encoder::finish(char *out, const size_t &out_size, size_t &written)
+{
+	written = 0;
+	if (out_size < UtilityFunctions::base64EncodedSize(pending_count, url_safe))
+	{
+		return false;
+	}
+
+	written = UtilityFunctions::base64EncodeTail(pending, pending_count, out, url_safe);
+	pending_count = 0;
+	return true;
+}
+
+/// <summary>
+/// Constructor for a Base64Decoder
+/// </summary>
+/// <param name="url_safe">If True, use the URL-safe alphabet ('-' and '_') (Defaults to False)</param>
+UtilityFunctions::Base64Decoder::Base64Decoder(const bool &url_safe) : url_safe(url_safe), pending_count(0), padded(false), error(false)
+{
+}
+
+/// <summary>
+/// Decodes the next chunk of base64. Up to 3 chars at the end of the chunk are held until the next chunk or finish().
+/// </summary>
+/// <param name="data">Pointer to the first base64 char of the chunk</param>
+/// <param name="size">Number of base64 chars in the chunk</param>
+/// <param name="out">Buffer for the bytes</param>
+/// <param name="out_size">Size of out in bytes. (size + 3) / 4 * 3 is always enough</param>
+/// <param name="written">size_t, passed by reference. Gets the number of bytes decoded</param>
+/// <returns>True on success. False if out is too small (nothing is consumed),
+/// or if the base64 is malformed (all later calls will also fail)</returns>
+bool UtilityFunctions::Base64Decoder::update(const char *data, const size_t &size, uint8_t *out, const size_t &out_size, size_t &written)
+{
+	written = 0;
+	if (error || out_size < (pending_count + size) / 4 * 3)
+	{
+		return false;
+	}
+
+	if (size == 0)
+	{
+		return true;
+	}
+
+	// Nothing may follow the padding
+	if (padded)
+	{
+		error = true;
+		return false;
+	}
+
+	size_t pos = 0;
+	if (pending_count > 0)
+	{
+		pos = std::min(4 - pending_count, size);
+		memcpy(pending + pending_count, data, pos);
+		pending_count += pos;
+
+		if (pending_count < 4)
+		{
+			return true;
+		}
+
+		pending_count = 0;
+		if (UtilityFunctions::base64DecodeBlock(pending, 4, out, url_safe) == 3)
+		{
+			written = 3;
+		}
+		else if (pending[3] == '=' && pos == size && UtilityFunctions::base64DecodeTail(pending, 4, out, written, url_safe))
+		{
+			padded = true;
+			return true;
+		}
+		else
+		{
+			error = true;
+			return false;
+		}
+	}
+
+	size_t body = (size - pos) / 4 * 4;
+	size_t decoded = UtilityFunctions::base64DecodeBlock(data + pos, body, out + written, url_safe);
+	written += decoded;
+
+	if (decoded != body / 4 * 3)
+	{
+		// Only the very last group of the stream may hold padding
+		size_t group = pos + decoded / 3 * 4;
+		size_t tail_written = 0;
+		if (group + 4 == size && data[size - 1] == '=' && UtilityFunctions::base64DecodeTail(data + group, 4, out + written, tail_written, url_safe))
+		{
+			written += tail_written;
+			padded = true;
+			return true;
+		}
+
+		error = true;
+		return false;
+	}
+
+	pos += body;
+	pending_count = size - pos;
+	memcpy(pending, data + pos, pending_count);
+	return true;
+}
+
+/// <summary>
+/// Decodes any held chars, leaving the Base64Decoder ready for a new stream.
+/// Held chars are only valid for URL-safe base64 without padding.
+/// </summary>
+/// <param name="out">Buffer for the bytes</param>
+/// <param name="out_size">Size of out in bytes. 2 is always enough</param>
+/// <param name="written">size_t, passed by reference. Gets the number of bytes decoded</param>
+/// <returns>True if the whole stream was valid base64, False otherwise</returns>
+bool UtilityFunctions::Base64Decoder::finish(uint8_t *out, const size_t &out_size, size_t &written)
+{
+	written = 0;
+	bool ret = !error;
+
+	if (ret && pending_count > 0)
+	{
+		ret = out_size >= UtilityFunctions::base64DecodedSize(pending_count) && UtilityFunctions::base64DecodeTail(pending, pending_count, out, written, url_safe);
+	}
+
+	pending_count = 0;
+	padded = false;
+	error = false;
+	return ret;
+}
+
+/// <summary>
+/// Hex encodes bytes without any size checks
+/// </summary>
+/// <param name="data">Pointer to the first byte</param>
+/// <param name="size">Number of bytes</param>
+/// <param name="out">Buffer for size * 2 chars</param>
+/// <param name="upper_case">If True, use A-F rather than a-f</param>
+void UtilityFunctions::hexEncodeBlock(const uint8_t *data, const size_t &size, char *out, const bool &upper_case)
+{
+	const char *digits = upper_case ? "0123456789ABCDEF" : "0123456789abcdef";
+	size_t pos = 0;
+
+#ifdef UTILITY_USE_SSE2
+	const __m128i low_nibble = _mm_set1_epi8(0x0F);
+	const __m128i nine = _mm_set1_epi8(9);
+	const __m128i zero_char = _mm_set1_epi8('0');
+	const __m128i letter_offset = _mm_set1_epi8(upper_case ? 'A' - '0' - 10 : 'a' - '0' - 10);
+
+	for (; pos + 16 <= size; pos += 16)
+	{
+		__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+		__m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), low_nibble);
+		__m128i low = _mm_and_si128(bytes, low_nibble);
+
+		// Interleave so each byte's high nibble comes before its low nibble
+		__m128i first = _mm_unpacklo_epi8(high, low);
+		__m128i second = _mm_unpackhi_epi8(high, low);
+
+		first = _mm_add_epi8(_mm_add_epi8(first, zero_char), _mm_and_si128(_mm_cmpgt_epi8(first, nine), letter_offset));
+		second = _mm_add_epi8(_mm_add_epi8(second, zero_char), _mm_and_si128(_mm_cmpgt_epi8(second, nine), letter_offset));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(out + pos * 2), first);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(out + pos * 2 + 16), second);
+	}
+#endif //UTILITY_USE_SSE2
+
+	for (; pos < size; pos++)
+	{
+		out[pos * 2] = digits[data[pos] >> 4];
+		out[pos * 2 + 1] = digits[data[pos] & 0x0F];
+	}
+}
+
+/// <summary>
+/// Decodes hex without any size checks
+/// </summary>
+/// <param name="data">Pointer to the first hex char</param>
+/// <param name="size">Number of hex chars. Must be even</param>
+/// <param name="out">Buffer for size / 2 bytes</param>
+/// <returns>Number of bytes decoded before the first pair holding a char that is not a hex digit</returns>
+size_t UtilityFunctions::hexDecodeBlock(const char *data, const size_t &size, uint8_t *out)
+{
+	size_t pos = 0;
+
+#ifdef UTILITY_USE_SSE2
+	const __m128i case_bit = _mm_set1_epi8(0x20);
+	const __m128i below_zero = _mm_set1_epi8('0' - 1);
+	const __m128i above_nine = _mm_set1_epi8('9' + 1);
+	const __m128i below_a = _mm_set1_epi8('a' - 1);
+	const __m128i above_f = _mm_set1_epi8('f' + 1);
+	const __m128i zero_char = _mm_set1_epi8('0');
+	const __m128i letter_base = _mm_set1_epi8('a' - 10);
+	const __m128i high_nibble = _mm_set1_epi16(0x00F0);
+
+	for (; pos + 16 <= size; pos += 16)
+	{
+		__m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+		__m128i lower = _mm_or_si128(chars, case_bit);
+
+		// Chars past 0x7F are negative here, so they fail both range checks
+		__m128i is_digit = _mm_and_si128(_mm_cmpgt_epi8(chars, below_zero), _mm_cmplt_epi8(chars, above_nine));
+		__m128i is_letter = _mm_and_si128(_mm_cmpgt_epi8(lower, below_a), _mm_cmplt_epi8(lower, above_f));
+
+		if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_letter)) != 0xFFFF)
+		{
+			break;
+		}
+
+		__m128i values = _mm_or_si128(
+			_mm_and_si128(is_digit, _mm_sub_epi8(chars, zero_char)),
+			_mm_and_si128(is_letter, _mm_sub_epi8(lower, letter_base)));
+
+		// Each 16 bit lane holds a pair: the high nibble in its low byte and the low nibble in its high byte
+		__m128i combined = _mm_or_si128(_mm_and_si128(_mm_slli_epi16(values, 4), high_nibble), _mm_srli_epi16(values, 8));
+		_mm_storel_epi64(reinterpret_cast<__m128i *>(out + pos / 2), _mm_packus_epi16(combined, combined));
+	}
+#endif //UTILITY_USE_SSE2
+
+	for (; pos < size; pos += 2)
+	{
+		int high = hexDigitValue(static_cast<unsigned char>(data[pos]));
+		int low = hexDigitValue(static_cast<unsigned char>(data[pos + 1]));
+		if (high < 0 || low < 0)
+		{
+			break;
+		}
+		out[pos / 2] = static_cast<uint8_t>((high << 4) | low);
+	}
+
+	return pos / 2;
+}
+
+/// <summary>
+/// Base64 encodes whole groups of 3 bytes without any size checks
+/// </summary>
+/// <param name="data">Pointer to the first byte</param>
+/// <param name="size">Number of bytes. Must be a multiple of 3</param>
+/// <param name="out">Buffer for size / 3 * 4 chars</param>
+/// <param name="url_safe">If True, use the URL-safe alphabet</param>
+void UtilityFunctions::base64EncodeBlock(const uint8_t *data, const size_t &size, char *out, const bool &url_safe)
+{
+	const char (*pairs)[2] = base64Tables().encode_pairs[url_safe ? 1 : 0];
+
+	for (size_t pos = 0; pos < size; pos += 3)
+	{
+		uint32_t bits = (static_cast<uint32_t>(data[pos]) << 16) | (static_cast<uint32_t>(data[pos + 1]) << 8) | data[pos + 2];
+		memcpy(out, pairs[bits >> 12], 2);
+		memcpy(out + 2, pairs[bits & 0xFFF], 2);
+		out += 4;
+	}
+}
+
+/// <summary>
+/// Base64 encodes the last 0 to 2 bytes of a stream, padding for standard base64
+/// </summary>
+/// <param name="data">Pointer to the first byte</param>
+/// <param name="size">Number of bytes (0 to 2)</param>
+/// <param name="out">Buffer for 4 chars, or size + 1 chars when url_safe</param>
+/// <param name="url_safe">If True, use the URL-safe alphabet without padding</param>
+/// <returns>Number of chars written</returns>
+size_t UtilityFunctions::base64EncodeTail(const uint8_t *data, const size_t &size, char *out, const bool &url_safe)
+{
+	if (size == 0)
+	{
+		return 0;
+	}
+
+	const char *alphabet = BASE64_ALPHABETS[url_safe ? 1 : 0];
+	uint32_t bits = static_cast<uint32_t>(data[0]) << 16;
+	if (size == 2)
+	{
+		bits |= static_cast<uint32_t>(data[1]) << 8;
+	}
+
+	out[0] = alphabet[bits >> 18];
+	out[1] = alphabet[(bits >> 12) & 0x3F];
+	if (size == 2)
+	{
+		out[2] = alphabet[(bits >> 6) & 0x3F];
+	}
+
+	// URL-safe output is unpadded, so out may only have room for the size + 1 meaningful chars
+	if (url_safe)
+	{
+		return size + 1;
+	}
+
+	if (size == 1)
+	{
+		out[2] = '=';
+	}
+	out[3] = '=';
+	return 4;
+}
+
+/// <summary>
+/// Decodes whole, unpadded groups of 4 base64 chars without any size checks
+/// </summary>
+/// <param name="data">Pointer to the first base64 char</param>
+/// <param name="size">Number of base64 chars. Must be a multiple of 4</param>
+/// <param name="out">Buffer for size / 4 * 3 bytes</param>
+/// <param name="url_safe">If True, use the URL-safe alphabet</param>
+/// <returns>Number of bytes decoded before the first group holding a char outside the alphabet (including '=')</returns>
+size_t UtilityFunctions::base64DecodeBlock(const char *data, const size_t &size, uint8_t *out, const bool &url_safe)
+{
+	const uint32_t (*decode)[256] = base64Tables().decode[url_safe ? 1 : 0];
+	const unsigned char *chars = reinterpret_cast<const unsigned char *>(data);
+	size_t pos = 0;
+
+	for (; pos < size; pos += 4)
+	{
+		uint32_t bits = decode[0][chars[pos]] | decode[1][chars[pos + 1]] | decode[2][chars[pos + 2]] | decode[3][chars[pos + 3]];
+		if (bits & BASE64_INVALID)
+		{
+			break;
+		}
+
+		out[0] = static_cast<uint8_t>(bits >> 16);
+		out[1] = static_cast<uint8_t>(bits >> 8);
+		out[2] = static_cast<uint8_t>(bits);
+		out += 3;
+	}
+
+	return pos / 4 * 3;
+}
+
+/// <summary>
+/// Decodes the last group of a base64 stream: 4 chars that may end in padding, or (URL-safe only) 2 or 3 unpadded chars.
+/// Unused bits of the last char must be zero, so each byte string has exactly one accepted encoding.
+/// </summary>
+/// <param name="data">Pointer to the first base64 char of the group</param>
+/// <param name="size">Number of base64 chars in the group (2 to 4)</param>
+/// <param name="out">Buffer for up to 3 bytes</param>
+/// <param name="written">size_t, passed by reference. Gets the number of bytes decoded</param>
+/// <param name="url_safe">If True, use the URL-safe alphabet and allow the group to be unpadded</param>
+/// <returns>True on success, False if the group is malformed</returns>
+bool UtilityFunctions::base64DecodeTail(const char *data, const size_t &size, uint8_t *out, size_t &written, const bool &url_safe)
+{
+	written = 0;
+	if (size < 2 || size > 4 || (size < 4 && !url_safe))
+	{
+		return false;
+	}
+
+	size_t chars = size;
+	if (size == 4 && data[3] == '=')
+	{
+		chars = data[2] == '=' ? 2 : 3;
+	}
+
+	const uint32_t (*decode)[256] = base64Tables().decode[url_safe ? 1 : 0];
+	uint32_t bits = 0;
+	for (size_t i = 0; i < chars; i++)
+	{
+		bits |= decode[i][static_cast<unsigned char>(data[i])];
+	}
+
+	size_t byte_count = chars - 1;
+	uint32_t unused_bits = byte_count == 3 ? 0 : (byte_count == 2 ? 0xFF : 0xFFFF);
+	if ((bits & BASE64_INVALID) || (bits & unused_bits))
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < byte_count; i++)
+	{
+		out[i] = static_cast<uint8_t>(bits >> (16 - 8 * i));
+	}
+	written = byte_count;
+	return true;
+}
+
 #endif UtilityFunctions_CPP
\ No newline at end of file
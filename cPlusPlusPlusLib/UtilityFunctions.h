@@ -24,6 +24,8 @@
 #include <sys/vfs.h>
 #endif //__linux
 
+#include "ThreadPool.h"
+
 /// <summary>
 /// Class for functions for performing general utilities.
 /// </summary>
@@ -38,6 +40,82 @@ public:
 
 	static std::vector<uint8_t>numericToLEBytes(const uint64_t &numeric);
 	static std::vector<uint8_t>numericToBEBytes(const uint64_t &numeric);
+
+	static size_t hexEncodedSize(const size_t &size);
+	static size_t hexEncode(const uint8_t *data, const size_t &size, char *out, const size_t &out_size, const bool &upper_case = false);
+	static std::string hexEncode(const std::vector<uint8_t> &bytes, const bool &upper_case = false);
+	static bool hexDecode(const char *data, const size_t &size, uint8_t *out, const size_t &out_size, size_t &written);
+	static bool hexDecode(const std::string &hex_str, std::vector<uint8_t> &bytes);
+
+	static size_t base64EncodedSize(const size_t &size, const bool &url_safe = false);
+	static size_t base64DecodedSize(const size_t &size);
+	static size_t base64Encode(const uint8_t *data, const size_t &size, char *out, const size_t &out_size, const bool &url_safe = false);
+	static std::string base64Encode(const std::vector<uint8_t> &bytes, const bool &url_safe = false);
+	static bool base64Decode(const char *data, const size_t &size, uint8_t *out, const size_t &out_size, size_t &written, const bool &url_safe = false);
+	static bool base64Decode(const std::string &base64_str, std::vector<uint8_t> &bytes, const bool &url_safe = false);
+
+	/// <summary>
+	/// Decodes hex given in chunks of any size (a byte may be split across chunks)
+	/// </summary>
+	class HexDecoder
+	{
+	public:
+		HexDecoder();
+
+		bool update(const char *data, const size_t &size, uint8_t *out, const size_t &out_size, size_t &written);
+		bool finish();
+
+	private:
+		char pending;
+		bool has_pending;
+		bool error;
+	};
+
+	/// <summary>
+	/// Encodes bytes given in chunks of any size to base64.
+	/// Standard base64 is padded with '=', URL-safe base64 is not.
+	/// </summary>
+	class Base64Encoder
+	{
+	public:
+		Base64Encoder(const bool &url_safe = false);
+
+		bool update(const uint8_t *data, const size_t &size, char *out, const size_t &out_size, size_t &written);
+		bool finish(char *out, const size_t &out_size, size_t &written);
+
+	private:
+		bool url_safe;
+		uint8_t pending[2];
+		size_t pending_count;
+	};
+
+	/// <summary>
+	/// Decodes base64 given in chunks of any size (a group of 4 chars may be split across chunks).
+	/// Standard base64 must be padded with '=', for URL-safe base64 the padding is optional.
+	/// </summary>
+	class Base64Decoder
+	{
+	public:
+		Base64Decoder(const bool &url_safe = false);
+
+		bool update(const char *data, const size_t &size, uint8_t *out, const size_t &out_size, size_t &written);
+		bool finish(uint8_t *out, const size_t &out_size, size_t &written);
+
+	private:
+		bool url_safe;
+		char pending[4];
+		size_t pending_count;
+		bool padded;
+		bool error;
+	};
+
+private:
+	static void hexEncodeBlock(const uint8_t *data, const size_t &size, char *out, const bool &upper_case);
+	static size_t hexDecodeBlock(const char *data, const size_t &size, uint8_t *out);
+	static void base64EncodeBlock(const uint8_t *data, const size_t &size, char *out, const bool &url_safe);
+	static size_t base64EncodeTail(const uint8_t *data, const size_t &size, char *out, const bool &url_safe);
+	static size_t base64DecodeBlock(const char *data, const size_t &size, uint8_t *out, const bool &url_safe);
+	static bool base64DecodeTail(const char *data, const size_t &size, uint8_t *out, size_t &written, const bool &url_safe);
 };
 
 #endif UtilityFunctions_H
\ No newline at end of file
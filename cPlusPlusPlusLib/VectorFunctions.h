@@ -8,10 +8,19 @@
 #define VectorFunctions_H
 
 #include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <iterator>
 #include <limits>
+#include <map>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "ThreadPool.h"
+
 /// <summary>
 /// Class of functions for std::vectors.
 /// </summary>
@@ -28,6 +37,7 @@ public:
 	template <typename T1, typename T2> static std::vector<std::pair<T1, T2>> zip(const std::vector<T1> &vec1, const std::vector<T2> &vec2)
 	{
 		size_t smaller_size = std::min(vec1.size(), vec2.size());
+		size_t larger_size = std::max(vec1.size(), vec2.size());
 
 		std::vector<std::pair<T1, T2>> ret_vec;
 
@@ -131,6 +141,514 @@ public:
 			std::cout << original_vec.back() << final_delimiter;
 		}
 	}
+
+	/// <summary>
+	/// Gets the number of elements below which the parallel algorithms run sequentially on the calling thread (Defaults to 32768)
+	/// </summary>
+	/// <returns>The threshold</returns>
+	static size_t getParallelThreshold()
+	{
+		return parallelThreshold().load(std::memory_order_relaxed);
+	}
+
+	/// <summary>
+	/// Sets the number of elements below which the parallel algorithms run sequentially on the calling thread.
+	/// Safe to call while parallel algorithms are running; calls already under way keep the value they started with.
+	/// </summary>
+	/// <param name="threshold">The new threshold</param>
+	static void setParallelThreshold(const size_t &threshold)
+	{
+		parallelThreshold().store(threshold, std::memory_order_relaxed);
+	}
+
+	/// <summary>
+	/// Applies func to every item in the original std::vector, in parallel for large inputs
+	/// </summary>
+	/// <param name="original_vec">The given std::vector<T></param>
+	/// <param name="func">Callable taking a const T &amp;. Must be safe to call from several threads at once</param>
+	/// <returns>std::vector of func's results, in the same order as original_vec</returns>
+	template <typename T, typename F> static auto map(const std::vector<T> &original_vec, F func) -> std::vector<typename std::decay<decltype(func(std::declval<const T &>()))>::type>
+	{
+		typedef typename std::decay<decltype(func(std::declval<const T &>()))>::type R;
+		static_assert(!std::is_same<R, bool>::value, "VectorFunctions::map cannot fill a std::vector<bool> from several threads");
+
+		std::vector<R> ret_vec(original_vec.size());
+
+		forEachChunk(original_vec.size(), chunkCount(original_vec.size()), [&](const size_t &, const size_t &begin, const size_t &end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				ret_vec[i] = func(original_vec[i]);
+			}
+		});
+
+		return ret_vec;
+	}
+
+	/// <summary>
+	/// Applies func to every item in the original std::vector, moving each item into func
+	/// </summary>
+	/// <param name="original_vec">The given std::vector<T>. Its items are left moved-from</param>
+	/// <param name="func">Callable taking a T &amp;&amp;. Must be safe to call from several threads at once</param>
+	/// <returns>std::vector of func's results, in the same order as original_vec</returns>
+	template <typename T, typename F> static auto map(std::vector<T> &&original_vec, F func) -> std::vector<typename std::decay<decltype(func(std::declval<T &&>()))>::type>
+	{
+		typedef typename std::decay<decltype(func(std::declval<T &&>()))>::type R;
+		static_assert(!std::is_same<R, bool>::value, "VectorFunctions::map cannot fill a std::vector<bool> from several threads");
+
+		std::vector<R> ret_vec(original_vec.size());
+
+		forEachChunk(original_vec.size(), chunkCount(original_vec.size()), [&](const size_t &, const size_t &begin, const size_t &end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				ret_vec[i] = func(std::move(original_vec[i]));
+			}
+		});
+
+		return ret_vec;
+	}
+
+	/// <summary>
+	/// Gets the items of the original std::vector for which pred returns true, in parallel for large inputs
+	/// </summary>
+	/// <param name="original_vec">The given std::vector<T></param>
+	/// <param name="pred">Callable taking a const T &amp; and returning bool. Must be safe to call from several threads at once</param>
+	/// <returns>std::vector<T> of the matching items, in their original order</returns>
+	template <typename T, typename P> static std::vector<T> filter(const std::vector<T> &original_vec, P pred)
+	{
+		size_t chunks = chunkCount(original_vec.size());
+		std::vector<std::vector<T>> chunk_vecs(chunks);
+
+		forEachChunk(original_vec.size(), chunks, [&](const size_t &chunk, const size_t &begin, const size_t &end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				if (pred(original_vec[i]))
+				{
+					chunk_vecs[chunk].push_back(original_vec[i]);
+				}
+			}
+		});
+
+		return concatenate(std::move(chunk_vecs));
+	}
+
+	/// <summary>
+	/// Gets the items of the original std::vector for which pred returns true, moving them instead of copying
+	/// </summary>
+	/// <param name="original_vec">The given std::vector<T>. Matching items are left moved-from</param>
+	/// <param name="pred">Callable taking a const T &amp; and returning bool. Must be safe to call from several threads at once</param>
+	/// <returns>std::vector<T> of the matching items, in their original order</returns>
+	template <typename T, typename P> static std::vector<T> filter(std::vector<T> &&original_vec, P pred)
+	{
+		size_t chunks = chunkCount(original_vec.size());
+		std::vector<std::vector<T>> chunk_vecs(chunks);
+
+		forEachChunk(original_vec.size(), chunks, [&](const size_t &chunk, const size_t &begin, const size_t &end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				if (pred(original_vec[i]))
+				{
+					chunk_vecs[chunk].push_back(std::move(original_vec[i]));
+				}
+			}
+		});
+
+		return concatenate(std::move(chunk_vecs));
+	}
+
+	/// <summary>
+	/// Combines all items of the original std::vector with op, in parallel for large inputs
+	/// </summary>
+	/// <param name="original_vec">The given std::vector<T></param>
+	/// <param name="init">The starting value</param>
+	/// <param name="op">Associative callable taking (const T &amp;, const T &amp;) and returning T</param>
+	/// <returns>init combined with every item of original_vec. Items are combined in order, but grouping may vary</returns>
+	template <typename T, typename Op> static T reduce(const std::vector<T> &original_vec, const T &init, Op op)
+	{
+		if (original_vec.empty())
+		{
+			return init;
+		}
+
+		size_t chunks = chunkCount(original_vec.size());
+		std::vector<T> partials;
+		partials.reserve(chunks);
+		for (size_t i = 0; i < chunks; i++)
+		{
+			partials.push_back(init);
+		}
+		std::vector<char> has_partial(chunks, 0);
+
+		forEachChunk(original_vec.size(), chunks, [&](const size_t &chunk, const size_t &begin, const size_t &end)
+		{
+			if (begin == end)
+			{
+				return;
+			}
+
+			T partial = original_vec[begin];
+			for (size_t i = begin + 1; i < end; i++)
+			{
+				partial = op(partial, original_vec[i]);
+			}
+			partials[chunk] = std::move(partial);
+			has_partial[chunk] = 1;
+		});
+
+		T ret_val = init;
+		for (size_t i = 0; i < partials.size(); i++)
+		{
+			if (has_partial[i])
+			{
+				ret_val = op(ret_val, partials[i]);
+			}
+		}
+
+		return ret_val;
+	}
+
+	/// <summary>
+	/// Splits the original std::vector into items for which pred returns true and items for which it returns false
+	/// </summary>
+	/// <param name="original_vec">The given std::vector<T></param>
+	/// <param name="pred">Callable taking a const T &amp; and returning bool. Must be safe to call from several threads at once</param>
+	/// <returns>std::pair of (matching items, non-matching items), each in their original order</returns>
+	template <typename T, typename P> static std::pair<std::vector<T>, std::vector<T>> partition(const std::vector<T> &original_vec, P pred)
+	{
+		size_t chunks = chunkCount(original_vec.size());
+		std::vector<std::vector<T>> matched(chunks);
+		std::vector<std::vector<T>> unmatched(chunks);
+
+		forEachChunk(original_vec.size(), chunks, [&](const size_t &chunk, const size_t &begin, const size_t &end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				if (pred(original_vec[i]))
+				{
+					matched[chunk].push_back(original_vec[i]);
+				}
+				else
+				{
+					unmatched[chunk].push_back(original_vec[i]);
+				}
+			}
+		});
+
+		return std::make_pair(concatenate(std::move(matched)), concatenate(std::move(unmatched)));
+	}
+
+	/// <summary>
+	/// Splits the original std::vector into items for which pred returns true and items for which it returns false, moving instead of copying
+	/// </summary>
+	/// <param name="original_vec">The given std::vector<T>. All items are left moved-from</param>
+	/// <param name="pred">Callable taking a const T &amp; and returning bool. Must be safe to call from several threads at once</param>
+	/// <returns>std::pair of (matching items, non-matching items), each in their original order</returns>
+	template <typename T, typename P> static std::pair<std::vector<T>, std::vector<T>> partition(std::vector<T> &&original_vec, P pred)
+	{
+		size_t chunks = chunkCount(original_vec.size());
+		std::vector<std::vector<T>> matched(chunks);
+		std::vector<std::vector<T>> unmatched(chunks);
+
+		forEachChunk(original_vec.size(), chunks, [&](const size_t &chunk, const size_t &begin, const size_t &end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				if (pred(original_vec[i]))
+				{
+					matched[chunk].push_back(std::move(original_vec[i]));
+				}
+				else
+				{
+					unmatched[chunk].push_back(std::move(original_vec[i]));
+				}
+			}
+		});
+
+		return std::make_pair(concatenate(std::move(matched)), concatenate(std::move(unmatched)));
+	}
+
+	/// <summary>
+	/// Breaks the original std::vector into consecutive chunks of chunk_size items
+	/// </summary>
+	/// <param name="original_vec">The given std::vector<T></param>
+	/// <param name="chunk_size">Number of items per chunk. The last chunk may be smaller</param>
+	/// <returns>std::vector of chunks. Empty if chunk_size is 0</returns>
+	template <typename T> static std::vector<std::vector<T>> chunked(const std::vector<T> &original_vec, const size_t &chunk_size)
+	{
+		std::vector<std::vector<T>> ret_vec;
+
+		if (chunk_size == 0)
+		{
+			return ret_vec;
+		}
+
+		ret_vec.reserve((original_vec.size() + chunk_size - 1) / chunk_size);
+		for (size_t i = 0; i < original_vec.size(); i += chunk_size)
+		{
+			ret_vec.emplace_back(original_vec.begin() + i, original_vec.begin() + std::min(i + chunk_size, original_vec.size()));
+		}
+
+		return ret_vec;
+	}
+
+	/// <summary>
+	/// Breaks the original std::vector into consecutive chunks of chunk_size items, moving instead of copying
+	/// </summary>
+	/// <param name="original_vec">The given std::vector<T>. All items are left moved-from</param>
+	/// <param name="chunk_size">Number of items per chunk. The last chunk may be smaller</param>
+	/// <returns>std::vector of chunks. Empty if chunk_size is 0</returns>
+	template <typename T> static std::vector<std::vector<T>> chunked(std::vector<T> &&original_vec, const size_t &chunk_size)
+	{
+		std::vector<std::vector<T>> ret_vec;
+
+		if (chunk_size == 0)
+		{
+			return ret_vec;
+		}
+
+		ret_vec.reserve((original_vec.size() + chunk_size - 1) / chunk_size);
+		for (size_t i = 0; i < original_vec.size(); i += chunk_size)
+		{
+			ret_vec.emplace_back(std::make_move_iterator(original_vec.begin() + i), std::make_move_iterator(original_vec.begin() + std::min(i + chunk_size, original_vec.size())));
+		}
+
+		return ret_vec;
+	}
+
+	/// <summary>
+	/// Sorts the given std::vector in place, in parallel for large inputs. Not stable.
+	/// </summary>
+	/// <param name="original_vec">The given std::vector<T></param>
+	/// <param name="comp">Strict weak ordering (Defaults to std::less)</param>
+	template <typename T, typename C = std::less<T>> static void sort(std::vector<T> &original_vec, C comp = C())
+	{
+		size_t chunks = chunkCount(original_vec.size());
+		std::vector<size_t> bounds(chunks + 1);
+		for (size_t chunk = 0; chunk <= chunks; chunk++)
+		{
+			bounds[chunk] = original_vec.size() * chunk / chunks;
+		}
+
+		forEachChunk(original_vec.size(), chunks, [&](const size_t &, const size_t &begin, const size_t &end)
+		{
+			std::sort(original_vec.begin() + begin, original_vec.begin() + end, comp);
+		});
+
+		// Merge neighbouring sorted runs until only one is left
+		while (bounds.size() > 2)
+		{
+			size_t merges = (bounds.size() - 1) / 2;
+			std::vector<size_t> next_bounds;
+
+			forEachChunk(merges, chunkCount(merges, 1), [&](const size_t &, const size_t &begin, const size_t &end)
+			{
+				for (size_t m = begin; m < end; m++)
+				{
+					std::inplace_merge(original_vec.begin() + bounds[m * 2], original_vec.begin() + bounds[m * 2 + 1], original_vec.begin() + bounds[m * 2 + 2], comp);
+				}
+			});
+
+			for (size_t i = 0; i < bounds.size(); i += 2)
+			{
+				next_bounds.push_back(bounds[i]);
+			}
+			if (next_bounds.back() != bounds.back())
+			{
+				next_bounds.push_back(bounds.back());
+			}
+			bounds = next_bounds;
+		}
+	}
+
+	/// <summary>
+	/// Gets the distinct items of the original std::vector
+	/// </summary>
+	/// <param name="original_vec">The given std::vector<T></param>
+	/// <returns>Sorted std::vector<T> with each distinct item once</returns>
+	template <typename T> static std::vector<T> unique(const std::vector<T> &original_vec)
+	{
+		return unique(std::vector<T>(original_vec));
+	}
+
+	/// <summary>
+	/// Gets the distinct items of the original std::vector, reusing its storage
+	/// </summary>
+	/// <param name="original_vec">The given std::vector<T>. Its storage is taken over by the returned std::vector</param>
+	/// <returns>Sorted std::vector<T> with each distinct item once</returns>
+	template <typename T> static std::vector<T> unique(std::vector<T> &&original_vec)
+	{
+		std::vector<T> ret_vec = std::move(original_vec);
+
+		VectorFunctions::sort(ret_vec);
+		ret_vec.erase(std::unique(ret_vec.begin(), ret_vec.end()), ret_vec.end());
+
+		return ret_vec;
+	}
+
+	/// <summary>
+	/// Merges two sorted std::vectors into one sorted std::vector, in parallel for large inputs.
+	/// Equal items from vec1 are placed before those from vec2.
+	/// </summary>
+	/// <param name="vec1">Given sorted std::vector 1</param>
+	/// <param name="vec2">Given sorted std::vector 2</param>
+	/// <param name="comp">Strict weak ordering both std::vectors are sorted by (Defaults to std::less)</param>
+	/// <returns>Sorted std::vector<T> holding every item of both</returns>
+	template <typename T, typename C = std::less<T>> static std::vector<T> sortedMerge(const std::vector<T> &vec1, const std::vector<T> &vec2, C comp = C())
+	{
+		std::vector<T> ret_vec(vec1.size() + vec2.size());
+		size_t chunks = chunkCount(ret_vec.size());
+
+		// Split the larger std::vector evenly and find the matching split in the smaller one
+		std::vector<size_t> split1(chunks + 1, vec1.size());
+		std::vector<size_t> split2(chunks + 1, vec2.size());
+		split1[0] = 0;
+		split2[0] = 0;
+		for (size_t c = 1; c < chunks; c++)
+		{
+			if (vec1.size() >= vec2.size())
+			{
+				split1[c] = vec1.size() * c / chunks;
+				split2[c] = split1[c] == vec1.size() ? vec2.size() : std::lower_bound(vec2.begin(), vec2.end(), vec1[split1[c]], comp) - vec2.begin();
+			}
+			else
+			{
+				split2[c] = vec2.size() * c / chunks;
+				split1[c] = split2[c] == vec2.size() ? vec1.size() : std::upper_bound(vec1.begin(), vec1.end(), vec2[split2[c]], comp) - vec1.begin();
+			}
+		}
+
+		forEachChunk(chunks, chunkCount(chunks, 1), [&](const size_t &, const size_t &begin, const size_t &end)
+		{
+			for (size_t c = begin; c < end; c++)
+			{
+				std::merge(vec1.begin() + split1[c], vec1.begin() + split1[c + 1], vec2.begin() + split2[c], vec2.begin() + split2[c + 1], ret_vec.begin() + split1[c] + split2[c], comp);
+			}
+		});
+
+		return ret_vec;
+	}
+
+	/// <summary>
+	/// Groups the items of the original std::vector by the key returned from key_func
+	/// </summary>
+	/// <param name="original_vec">The given std::vector<T></param>
+	/// <param name="key_func">Callable taking a const T &amp; and returning the key. Must be safe to call from several threads at once</param>
+	/// <returns>std::map from key to the items with that key, in their original order</returns>
+	template <typename T, typename F> static auto groupBy(const std::vector<T> &original_vec, F key_func) -> std::map<typename std::decay<decltype(key_func(std::declval<const T &>()))>::type, std::vector<T>>
+	{
+		typedef typename std::decay<decltype(key_func(std::declval<const T &>()))>::type K;
+
+		size_t chunks = chunkCount(original_vec.size());
+		std::vector<std::map<K, std::vector<T>>> chunk_maps(chunks);
+
+		forEachChunk(original_vec.size(), chunks, [&](const size_t &chunk, const size_t &begin, const size_t &end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				chunk_maps[chunk][key_func(original_vec[i])].push_back(original_vec[i]);
+			}
+		});
+
+		std::map<K, std::vector<T>> ret_map;
+		for (std::map<K, std::vector<T>> &chunk_map : chunk_maps)
+		{
+			for (typename std::map<K, std::vector<T>>::value_type &group : chunk_map)
+			{
+				std::vector<T> &dest = ret_map[group.first];
+				if (dest.empty())
+				{
+					dest = std::move(group.second);
+				}
+				else
+				{
+					dest.insert(dest.end(), std::make_move_iterator(group.second.begin()), std::make_move_iterator(group.second.end()));
+				}
+			}
+		}
+
+		return ret_map;
+	}
+
+private:
+	/// <summary>
+	/// The threshold behind getParallelThreshold() and setParallelThreshold()
+	/// </summary>
+	/// <returns>Reference to the threshold</returns>
+	static std::atomic<size_t> &parallelThreshold()
+	{
+		static std::atomic<size_t> threshold(32768);
+		return threshold;
+	}
+
+	/// <summary>
+	/// Gets the number of chunks to split size items into.
+	/// Reads the threshold once, so callers should call this once and pass the result to forEachChunk().
+	/// </summary>
+	/// <param name="size">Number of items</param>
+	/// <param name="min_size">Smallest size worth splitting (Defaults to getParallelThreshold())</param>
+	/// <returns>1 for small inputs, otherwise the number of threads in ThreadPool::shared() (capped at size)</returns>
+	static size_t chunkCount(const size_t &size, const size_t &min_size = 0)
+	{
+		size_t threshold = min_size == 0 ? getParallelThreshold() : min_size;
+		if (size < threshold || size < 2)
+		{
+			return 1;
+		}
+
+		return std::min(ThreadPool::shared().size(), size);
+	}
+
+	/// <summary>
+	/// Splits [0, size) into the given number of contiguous ranges and calls func(chunk, begin, end) on each.
+	/// The ranges run on ThreadPool::shared() with the calling thread helping. Returns once all are done.
+	/// </summary>
+	/// <param name="size">Number of items</param>
+	/// <param name="chunks">Number of ranges, from chunkCount()</param>
+	/// <param name="func">Callable taking (chunk index, begin index, end index)</param>
+	template <typename F> static void forEachChunk(const size_t &size, const size_t &chunks, F func)
+	{
+		if (chunks == 1)
+		{
+			func(0, 0, size);
+			return;
+		}
+
+		ThreadPool::shared().parallelFor(0, chunks, [&func, chunks, size](const size_t &chunk)
+		{
+			func(chunk, size * chunk / chunks, size * (chunk + 1) / chunks);
+		}, 1);
+	}
+
+	/// <summary>
+	/// Moves a std::vector of std::vectors into one std::vector
+	/// </summary>
+	/// <param name="vecs">The std::vectors to concatenate</param>
+	/// <returns>One std::vector holding every item, in order</returns>
+	template <typename T> static std::vector<T> concatenate(std::vector<std::vector<T>> &&vecs)
+	{
+		if (vecs.size() == 1)
+		{
+			return std::move(vecs.front());
+		}
+
+		size_t total = 0;
+		for (const std::vector<T> &vec : vecs)
+		{
+			total += vec.size();
+		}
+
+		std::vector<T> ret_vec;
+		ret_vec.reserve(total);
+		for (std::vector<T> &vec : vecs)
+		{
+			ret_vec.insert(ret_vec.end(), std::make_move_iterator(vec.begin()), std::make_move_iterator(vec.end()));
+		}
+
+		return ret_vec;
+	}
 };
 
 #endif VectorFunctions_H
\ No newline at end of file
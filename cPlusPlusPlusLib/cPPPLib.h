@@ -7,7 +7,22 @@
 #ifndef cPPPLib_H
 #define cPPPLib_H
 
+#include "CsvParser.h"
+#include "FileWriter.h"
+#include "HashFunctions.h"
+#include "MappedFile.h"
+#include "NumberFunctions.h"
+#include "PipelineStage.h"
+#include "Profiler.h"
+#include "RingBuffer.h"
+#include "SimilarityFunctions.h"
+#include "SmallVector.h"
 #include "StringFunctions.h"
+#include "StringPool.h"
+#include "StringView.h"
+#include "ThreadPool.h"
+#include "TrigramIndex.h"
+#include "Utf8Functions.h"
 #include "UtilityFunctions.h"
 #include "VectorFunctions.h"
 